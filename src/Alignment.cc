@@ -32,8 +32,14 @@ void Alignment::makeXdrop( Aligners &aligners, bool isGreedy, bool isFullScore,
                            const TwoQualityScoreMatrix& sm2qual,
                            const uchar* qual1, const uchar* qual2,
 			   const Alphabet& alph, AlignmentExtras& extras,
-			   double gamma, int outputType ){
+			   double gamma, int outputType,
+			   bool isSaveExtensions ){
   std::vector<char> &columnAmbiguityCodes = extras.columnAmbiguityCodes;
+  std::vector<XdropExtension> oldExtensions;
+  if (isSaveExtensions) xdropExtensions.resize(2);
+  else oldExtensions.swap(xdropExtensions);
+  XdropExtension *ext = isSaveExtensions ? &xdropExtensions[0]
+    : oldExtensions.empty() ? 0 : &oldExtensions[0];
   if (probMatrix) score = seed.score;  // else keep the old score
   if (outputType > 3 && !isFullScore) extras.fullScore = seed.score;
   blocks.clear();
@@ -51,7 +57,7 @@ void Alignment::makeXdrop( Aligners &aligners, bool isGreedy, bool isFullScore,
 	  seq1, seq2, seed.beg1(), seed.beg2(), false, globality,
 	  scoreMatrix, smMax, smMin, probMatrix, scale, maxDrop, gap,
 	  frameSize, pssm2, sm2qual, qual1, qual2, alph,
-	  extras, gamma, outputType );
+	  extras, gamma, outputType, ext, isSaveExtensions );
 
   if( score == -INF ) return;  // maybe unnecessary?
 
@@ -84,7 +90,7 @@ void Alignment::makeXdrop( Aligners &aligners, bool isGreedy, bool isFullScore,
 	  seq1, seq2, seed.end1(), seed.end2(), true, globality,
 	  scoreMatrix, smMax, smMin, probMatrix, scale, maxDrop, gap,
 	  frameSize, pssm2, sm2qual, qual1, qual2, alph,
-	  extras, gamma, outputType );
+	  extras, gamma, outputType, ext ? ext + 1 : 0, isSaveExtensions );
 
   if( score == -INF ) return;  // maybe unnecessary?
 
@@ -261,7 +267,8 @@ void Alignment::extend( Aligners &aligners, bool isGreedy, bool isFullScore,
 			const TwoQualityScoreMatrix& sm2qual,
                         const uchar* qual1, const uchar* qual2,
 			const Alphabet& alph, AlignmentExtras& extras,
-			double gamma, int outputType ){
+			double gamma, int outputType,
+			XdropExtension *ext, bool isSaveExt ){
   const GapCosts::Piece &del = gap.delPieces[0];
   const GapCosts::Piece &ins = gap.insPieces[0];
   Centroid &centroid = aligners.centroid;
@@ -269,6 +276,8 @@ void Alignment::extend( Aligners &aligners, bool isGreedy, bool isFullScore,
   GreedyXdropAligner &greedyAligner = aligners.greedyAligner;
   std::vector<char> &columnCodes = extras.columnAmbiguityCodes;
   size_t blocksBeg = blocks.size();
+  bool isReuse = ext && !isSaveExt && !ext->shape.empty();
+  if (isSaveExt) ext->shape.clear();
 
   double *subsCounts[scoreMatrixRowSize];
   double *tranCounts;
@@ -345,7 +354,8 @@ void Alignment::extend( Aligners &aligners, bool isGreedy, bool isFullScore,
 	isSimdMatrix = false;
 
   int extensionScore =
-    isGreedy  ? greedyAligner.align(seq1.beg + start1, s2,
+    isReuse   ? ext->score
+    : isGreedy ? greedyAligner.align(seq1.beg + start1, s2,
 				    isForward, sm, maxDrop, alph.size)
     : sm2qual ? aligner.align2qual(seq1.beg + start1, qual1 + start1,
 				   s2, qual2 + start2,
@@ -374,7 +384,11 @@ void Alignment::extend( Aligners &aligners, bool isGreedy, bool isFullScore,
     return;  // avoid ill-defined probabilistic alignment
   }
 
-  if( outputType < 5 || outputType > 6 ){  // ordinary max-score alignment
+  if (isReuse) {
+    aligner.setShape(ext->shape);
+    if (outputType < 5 || outputType > 6)
+      blocks.insert(blocks.end(), ext->chunks.begin(), ext->chunks.end());
+  } else if( outputType < 5 || outputType > 6 ){  // max-score alignment
     size_t end1, end2, size;
     if( isGreedy ){
       while( greedyAligner.getNextChunk( end1, end2, size ) )
@@ -396,6 +410,12 @@ void Alignment::extend( Aligners &aligners, bool isGreedy, bool isFullScore,
     }
   }
 
+  if (isSaveExt && !isGreedy && outputType < 4) {
+    aligner.getShape(ext->shape);
+    ext->chunks.assign(blocks.begin() + blocksBeg, blocks.end());
+    ext->score = extensionScore;
+  }
+
   if (!probMat) return;
   if (!isFullScore) score += extensionScore;
 
@@ -8,6 +8,7 @@
 #include "Centroid.hh"
 #include "GreedyXdropAligner.hh"
 #include "SegmentPair.hh"
+#include "mcf_arena.hh"
 #include "mcf_frameshift_xdrop_aligner.hh"
 
 #include <vector>
@@ -72,6 +73,14 @@ struct AlignmentExtras {
   AlignmentExtras() : fullScore(0) {}
 };
 
+struct XdropExtension {
+  // A gapped X-drop extension in one direction from a seed, kept so
+  // that it needn't be redone.
+  std::vector<size_t> shape;  // the x-drop region (see GappedXdropAligner)
+  std::vector<SegmentPair> chunks;  // the max-score path, as extend finds it
+  int score;
+};
+
 struct Alignment{
   // make a single-block alignment:
   void fromSegmentPair(const SegmentPair &sp) {
@@ -84,6 +93,9 @@ struct Alignment{
   // Alignment might not be "optimal" (see below).
   // If outputType > 3: calculates match probabilities.
   // If outputType > 4: does gamma-centroid alignment.
+  // If isSaveExtensions: puts the extensions in xdropExtensions.
+  // Else, if there are xdropExtensions, re-uses (and then discards)
+  // them: this is only valid if the seed and scoring are unchanged.
   void makeXdrop( Aligners &aligners, bool isGreedy, bool isFullScore,
 		  BigSeq seq1, const uchar* seq2, int globality,
 		  const ScoreMatrixRow* scoreMatrix, int smMax, int smMin,
@@ -93,7 +105,8 @@ struct Alignment{
                   const TwoQualityScoreMatrix& sm2qual,
                   const uchar* qual1, const uchar* qual2,
 		  const Alphabet& alph, AlignmentExtras& extras,
-		  double gamma = 0, int outputType = 0 );
+		  double gamma = 0, int outputType = 0,
+		  bool isSaveExtensions = false );
 
   // Check that the Alignment has no prefix with score <= 0, no suffix
   // with score <= 0, and no sub-segment with score < -maxDrop.
@@ -117,18 +130,44 @@ struct Alignment{
   // translationType indicates that the 2nd sequence is: 0 = not
   // translated, 1 = translated into amino acids, 2 = translated into
   // codons (so codonToAmino is used to count matches & dnaAlph is
-  // used to write the 2nd sequence).
+  // used to write the 2nd sequence).  The text is allocated from
+  // "arena", so it lasts until the arena is reset.
   AlignmentText write(const MultiSequence& seq1, const MultiSequence& seq2,
 		      size_t seqNum2, const uchar* seqData2,
 		      const Alphabet& alph, const Alphabet& dnaAlph,
 		      int translationType, const uchar *codonToAmino,
 		      const LastEvaluer& evaluer, int format,
-		      const AlignmentExtras& extras) const;
+		      const AlignmentExtras& extras, mcf::Arena &arena) const;
+
+  // Like "write", but the text is the data for making a
+  // cbrc::UnsplitAlignment directly (starting with a
+  // cbrc::UnsplitAlignmentHead), instead of MAF
+  AlignmentText writeForSplit(const MultiSequence& seq1,
+			      const MultiSequence& seq2,
+			      size_t seqNum2, const uchar* seqData2,
+			      const Alphabet& alph,
+			      const AlignmentExtras& extras,
+			      mcf::Arena &arena) const;
+
+  // Like "writeForSplit", but the text is a binary record, as
+  // described in mcf_alignment_records.hh
+  AlignmentText writeRecord(const MultiSequence& seq1,
+			    const MultiSequence& seq2,
+			    size_t seqNum2, const uchar* seqData2,
+			    const Alphabet& alph, const LastEvaluer& evaluer,
+			    const AlignmentExtras& extras,
+			    mcf::Arena &arena) const;
+
+  // The query coordinates and score that "write" would return, but
+  // with no text, so we can cull alignments before writing them
+  AlignmentText textKey(const MultiSequence& seq2, size_t seqNum2,
+			int translationType) const;
 
   // data:
   std::vector<SegmentPair> blocks;  // the gapless blocks of the alignment
   double score;
   SegmentPair seed;  // the alignment remembers its seed
+  std::vector<XdropExtension> xdropExtensions;  // reverse, forward
 
   size_t beg1() const{ return blocks.front().beg1(); }
   size_t beg2() const{ return blocks.front().beg2(); }
@@ -145,18 +184,19 @@ struct Alignment{
                const TwoQualityScoreMatrix& sm2qual,
                const uchar* qual1, const uchar* qual2,
 	       const Alphabet& alph, AlignmentExtras& extras,
-	       double gamma, int outputType );
+	       double gamma, int outputType,
+	       XdropExtension *ext, bool isSaveExt );
 
   AlignmentText writeTab(const MultiSequence& seq1, const MultiSequence& seq2,
 			 size_t seqNum2, int translationType,
 			 const LastEvaluer& evaluer,
-			 const AlignmentExtras& extras) const;
+			 const AlignmentExtras& extras, mcf::Arena &arena) const;
 
   AlignmentText writeMaf(const MultiSequence& seq1, const MultiSequence& seq2,
 			 size_t seqNum2, const uchar* seqData2,
 			 const Alphabet& alph, const Alphabet& dnaAlph,
 			 int translationType, const LastEvaluer& evaluer,
-			 const AlignmentExtras& extras) const;
+			 const AlignmentExtras& extras, mcf::Arena &arena) const;
 
   AlignmentText writeBlastTab(const MultiSequence& seq1,
 			      const MultiSequence& seq2,
@@ -165,7 +205,7 @@ struct Alignment{
 			      const uchar *codonToAmino,
 			      const LastEvaluer& evaluer,
 			      const AlignmentExtras& extras,
-			      bool isExtraColumns) const;
+			      bool isExtraColumns, mcf::Arena &arena) const;
 
   size_t numColumns(size_t frameSize, bool isCodon) const;
 
@@ -5,6 +5,8 @@
 #include "LastEvaluer.hh"
 #include "MultiSequence.hh"
 #include "Alphabet.hh"
+#include "mcf_alignment_records.hh"
+#include "split/cbrc_unsplit_alignment.hh"
 
 #include <assert.h>
 
@@ -126,17 +128,33 @@ AlignmentText Alignment::write(const MultiSequence& seq1,
 			       const Alphabet& alph, const Alphabet& dnaAlph,
 			       int translationType, const uchar *codonToAmino,
 			       const LastEvaluer& evaluer, int format,
-			       const AlignmentExtras& extras) const {
+			       const AlignmentExtras& extras,
+			       mcf::Arena &arena) const {
   assert(!blocks.empty());
 
   if (format == 'm')
     return writeMaf(seq1, seq2, seqNum2, seqData2,
-		    alph, dnaAlph, translationType, evaluer, extras);
+		    alph, dnaAlph, translationType, evaluer, extras, arena);
+  if (format == 'r')
+    return writeRecord(seq1, seq2, seqNum2, seqData2, alph, evaluer, extras,
+		       arena);
   if (format == 't')
-    return writeTab(seq1, seq2, seqNum2, translationType, evaluer, extras);
+    return writeTab(seq1, seq2, seqNum2, translationType, evaluer, extras,
+		    arena);
   else
     return writeBlastTab(seq1, seq2, seqNum2, seqData2, alph, translationType,
-			 codonToAmino, evaluer, extras, format == 'B');
+			 codonToAmino, evaluer, extras, format == 'B', arena);
+}
+
+AlignmentText Alignment::textKey(const MultiSequence& seq2, size_t seqNum2,
+				 int translationType) const {
+  size_t size2 = seq2.padLen(seqNum2);
+  size_t frameSize2 = translationType ? (size2 / 3) : 0;
+  size_t alnBeg2 = aaToDna( beg2(), frameSize2 );
+  size_t alnEnd2 = aaToDna( end2(), frameSize2 );
+  char strand2 = seq2.strand(seqNum2);
+  return AlignmentText(seqNum2, alnBeg2, alnEnd2, size2, strand2, score,
+		       0, 0, 0);
 }
 
 static size_t alignedColumnCount(const std::vector<SegmentPair> &blocks) {
@@ -221,7 +239,8 @@ AlignmentText Alignment::writeTab(const MultiSequence& seq1,
 				  const MultiSequence& seq2,
 				  size_t seqNum2, int translationType,
 				  const LastEvaluer& evaluer,
-				  const AlignmentExtras& extras) const {
+				  const AlignmentExtras& extras,
+				  mcf::Arena &arena) const {
   size_t alnBeg1 = beg1();
   size_t alnEnd1 = end1();
   size_t seqNum1 = seq1.whichSequence(alnBeg1);
@@ -259,7 +278,7 @@ AlignmentText Alignment::writeTab(const MultiSequence& seq1,
     n1.size() + b1.size() + r1.size() + 1 + s1.size() + 5 +
     n2.size() + b2.size() + r2.size() + 1 + s2.size() + 5 + blockLen + tagLen;
 
-  char *text = new char[textLen + 1];
+  char *text = arena.alloc(textLen + 1);
   Writer w(text);
   w << sc << t;
   w << n1 << t << b1 << t << r1 << t << strand1 << t << s1 << t;
@@ -364,7 +383,8 @@ AlignmentText Alignment::writeMaf(const MultiSequence& seq1,
 				  const Alphabet& dnaAlph,
 				  int translationType,
 				  const LastEvaluer& evaluer,
-				  const AlignmentExtras& extras) const {
+				  const AlignmentExtras& extras,
+				  mcf::Arena &arena) const {
   bool isCodon = (translationType == 2);
   double fullScore = extras.fullScore;
   const std::vector<char>& columnProbSymbols = extras.columnAmbiguityCodes;
@@ -417,7 +437,7 @@ AlignmentText Alignment::writeMaf(const MultiSequence& seq1,
 
   size_t sLineNum = 2 + isQuals1 + isQuals2 + !columnProbSymbols.empty();
   size_t textLen = aLineLen + sLineLen * sLineNum + cLine.size() + 1;
-  char *text = new char[textLen + 1];
+  char *text = arena.alloc(textLen + 1);
 
   char *dest = std::copy(aLine, aLineEnd, text);
 
@@ -463,6 +483,157 @@ AlignmentText Alignment::writeMaf(const MultiSequence& seq1,
 		       0, 0, text);
 }
 
+AlignmentText Alignment::writeForSplit(const MultiSequence& seq1,
+				       const MultiSequence& seq2,
+				       size_t seqNum2, const uchar* seqData2,
+				       const Alphabet& alph,
+				       const AlignmentExtras& extras,
+				       mcf::Arena &arena) const {
+  const std::vector<char>& columnProbSymbols = extras.columnAmbiguityCodes;
+
+  size_t alnBeg1 = beg1();
+  size_t seqNum1 = seq1.whichSequence(alnBeg1);
+  size_t size2 = seq2.padLen(seqNum2);
+  size_t seqOrigin2 = seq2.padBeg(seqNum2);
+  char strand2 = seq2.strand(seqNum2);
+
+  UnsplitAlignmentHead h;
+  h.rstart = alnBeg1 - seq1.seqBeg(seqNum1);
+  h.rspan = end1() - alnBeg1;
+  h.rlength = seq1.seqLen(seqNum1);
+  h.qstart = beg2() - (seq2.seqBeg(seqNum2) - seqOrigin2);
+  h.qspan = end2() - beg2();
+  h.qlength = seq2.seqLen(seqNum2);
+  h.rstrand = seq1.strand(seqNum1);
+  h.qstrand = strand2;
+  h.isQual = seq2.qualsPerLetter();
+  h.isProbs = !columnProbSymbols.empty();
+  h.isCounts = !extras.expectedCounts.empty();
+
+  const std::string n1 = seq1.seqName(seqNum1);
+  const std::string n2 = seq2.seqName(seqNum2);
+  size_t alnLen = numColumns(0, false);
+  size_t numOfRows = 2 + h.isQual + h.isProbs;
+  char *text =
+    arena.alloc(sizeof h + n1.size() + n2.size() + 2 + (alnLen + 1) * numOfRows);
+
+  memcpy(text, &h, sizeof h);
+  Writer w(text + sizeof h);
+  w << n1 << '\0' << n2 << '\0';
+  char *dest = w.pointer();
+  dest = writeTopSeq(dest, seq1.seqPtr(), alph, 0, 0, false);
+  *dest++ = 0;
+  BigSeq bigSeq2 = {seqData2, false};
+  dest = writeBotSeq(dest, bigSeq2, alph, 0, 0, false);
+  *dest++ = 0;
+  if (h.isQual) {
+    size_t qualsPerBase2 = seq2.qualsPerLetter();
+    BigSeq q = {seq2.qualityReader() + seqOrigin2 * qualsPerBase2, false};
+    dest = writeBotSeq(dest, q, alph, qualsPerBase2, 0, false);
+    *dest++ = 0;
+  }
+  if (h.isProbs) {
+    dest = writeColumnProbs(dest, &columnProbSymbols[0], 0, false);
+    *dest++ = 0;
+  }
+
+  return AlignmentText(seqNum2, beg2(), end2(), size2, strand2, score,
+		       0, 0, text);
+}
+
+AlignmentText Alignment::writeRecord(const MultiSequence& seq1,
+				     const MultiSequence& seq2,
+				     size_t seqNum2, const uchar* seqData2,
+				     const Alphabet& alph,
+				     const LastEvaluer& evaluer,
+				     const AlignmentExtras& extras,
+				     mcf::Arena &arena) const {
+  const std::vector<char>& columnProbSymbols = extras.columnAmbiguityCodes;
+
+  size_t alnBeg1 = beg1();
+  size_t seqNum1 = seq1.whichSequence(alnBeg1);
+  size_t size2 = seq2.padLen(seqNum2);
+  size_t seqOrigin2 = seq2.padBeg(seqNum2);
+  char strand2 = seq2.strand(seqNum2);
+  size_t seqLen2 = seq2.seqLen(seqNum2);
+
+  mcf::AlignmentRecordHead r;
+  r.score = score;
+  r.fullScore = extras.fullScore;
+  r.isEvalue = evaluer.isGood();
+  r.eg2 = r.evalue = r.bitScore = 0;
+  if (r.isEvalue) {
+    double epa = evaluer.evaluePerArea(score);
+    r.eg2 = 1e18 * epa;
+    r.evalue = evaluer.area(score, seqLen2) * epa;
+    r.bitScore = evaluer.bitScore(score);
+  }
+  r.isRefQual = seq1.qualsPerLetter();
+
+  UnsplitAlignmentHead h;
+  h.rstart = alnBeg1 - seq1.seqBeg(seqNum1);
+  h.rspan = end1() - alnBeg1;
+  h.rlength = seq1.seqLen(seqNum1);
+  h.qstart = beg2() - (seq2.seqBeg(seqNum2) - seqOrigin2);
+  h.qspan = end2() - beg2();
+  h.qlength = seqLen2;
+  h.rstrand = seq1.strand(seqNum1);
+  h.qstrand = strand2;
+  h.isQual = seq2.qualsPerLetter();
+  h.isProbs = !columnProbSymbols.empty();
+  h.isCounts = !extras.expectedCounts.empty();
+
+  std::vector<char> cLine;
+  writeMafLineC(cLine, extras.expectedCounts, alph, false);
+
+  const std::string n1 = seq1.seqName(seqNum1);
+  const std::string n2 = seq2.seqName(seqNum2);
+  size_t alnLen = numColumns(0, false);
+  size_t numOfRows = 2 + h.isQual + h.isProbs + r.isRefQual;
+  size_t size = sizeof r + sizeof h + n1.size() + n2.size() + 2 +
+    (alnLen + 1) * numOfRows + cLine.size();
+  char *text = arena.alloc(mcf::recordPrefixSize + size);
+
+  uint32_t recordSize = size;
+  text[0] = 0;
+  memcpy(text + 1, &recordSize, sizeof recordSize);
+  char *dest = text + mcf::recordPrefixSize;
+  memcpy(dest, &r, sizeof r);
+  dest += sizeof r;
+  memcpy(dest, &h, sizeof h);
+  dest += sizeof h;
+  Writer w(dest);
+  w << n1 << '\0' << n2 << '\0';
+  dest = w.pointer();
+  dest = writeTopSeq(dest, seq1.seqPtr(), alph, 0, 0, false);
+  *dest++ = 0;
+  BigSeq bigSeq2 = {seqData2, false};
+  dest = writeBotSeq(dest, bigSeq2, alph, 0, 0, false);
+  *dest++ = 0;
+  if (h.isQual) {
+    size_t qualsPerBase2 = seq2.qualsPerLetter();
+    BigSeq q = {seq2.qualityReader() + seqOrigin2 * qualsPerBase2, false};
+    dest = writeBotSeq(dest, q, alph, qualsPerBase2, 0, false);
+    *dest++ = 0;
+  }
+  if (h.isProbs) {
+    dest = writeColumnProbs(dest, &columnProbSymbols[0], 0, false);
+    *dest++ = 0;
+  }
+  if (r.isRefQual) {
+    BigSeq q = {seq1.qualityReader(), false};
+    dest = writeTopSeq(dest, q, alph, seq1.qualsPerLetter(), 0, false);
+    *dest++ = 0;
+  }
+  if (h.isCounts) {  // without the newline
+    memcpy(dest, &cLine[0], cLine.size() - 1);
+    dest[cLine.size() - 1] = 0;
+  }
+
+  return AlignmentText(seqNum2, beg2(), end2(), size2, strand2, score,
+		       0, 0, text);
+}
+
 AlignmentText Alignment::writeBlastTab(const MultiSequence& seq1,
 				       const MultiSequence& seq2,
 				       size_t seqNum2, const uchar* seqData2,
@@ -471,7 +642,8 @@ AlignmentText Alignment::writeBlastTab(const MultiSequence& seq1,
 				       const uchar *codonToAmino,
 				       const LastEvaluer& evaluer,
 				       const AlignmentExtras& extras,
-				       bool isExtraColumns) const {
+				       bool isExtraColumns,
+				       mcf::Arena &arena) const {
   size_t alnBeg1 = beg1();
   size_t alnEnd1 = end1();
   size_t seqNum1 = seq1.whichSequence(alnBeg1);
@@ -547,7 +719,7 @@ AlignmentText Alignment::writeBlastTab(const MultiSequence& seq1,
     s += s1.size() + s2.size() + sc.size() + 3;
   }
 
-  char *text = new char[s + 1];
+  char *text = arena.alloc(s + 1);
   Writer w(text);
   const char t = '\t';
   w << n2 << t << n1 << t << mp << t << as << t << mm << t << go << t
@@ -11,6 +11,52 @@ static const double DINF = DBL_MAX / 2;
 
 namespace cbrc{
 
+using namespace mcf;
+
+typedef const double *const_dbl_ptr;
+
+// The match probabilities for the next simdDblLen cells of an
+// antidiagonal, which go forward in seq1 and backward in seq2
+static inline SimdDbl matchProbsV(const const_dbl_ptr *substitutionProbs,
+				  const uchar *s1, const uchar *s2, int inc) {
+  return simdSetDbl(
+#if defined __SSE4_1__ || defined __ARM_NEON
+#ifdef __AVX2__
+#ifdef __AVX512BW__
+		    substitutionProbs[s1[7]][s2[-7 * inc]],
+		    substitutionProbs[s1[6]][s2[-6 * inc]],
+		    substitutionProbs[s1[5]][s2[-5 * inc]],
+		    substitutionProbs[s1[4]][s2[-4 * inc]],
+#endif
+		    substitutionProbs[s1[3]][s2[-3 * inc]],
+		    substitutionProbs[s1[2]][s2[-2 * inc]],
+#endif
+		    substitutionProbs[s1[1]][s2[-inc]],
+#endif
+		    substitutionProbs[s1[0]][s2[0]]);
+}
+
+static inline SimdDbl matchProbsV(const double (*p2)[scoreMatrixRowSize],
+				  const uchar *s1, int inc) {
+  return simdSetDbl(
+#if defined __SSE4_1__ || defined __ARM_NEON
+#ifdef __AVX2__
+#ifdef __AVX512BW__
+		    p2[-7 * inc][s1[7]],
+		    p2[-6 * inc][s1[6]],
+		    p2[-5 * inc][s1[5]],
+		    p2[-4 * inc][s1[4]],
+#endif
+		    p2[-3 * inc][s1[3]],
+		    p2[-2 * inc][s1[2]],
+#endif
+		    p2[-inc][s1[1]],
+#endif
+		    p2[0][s1[0]]);
+}
+
+#if !defined MCF_SIMD_TIER
+
   void Centroid::setPssm( const ScoreMatrixRow* pssm, size_t qsize, double T,
 			  const OneQualityExpMatrix& oqem,
 			  const uchar* sequenceBeg, const uchar* qualityBeg ) {
@@ -62,10 +108,20 @@ namespace cbrc{
     }
   }
 
-  double Centroid::forward(BigPtr seq1, const uchar *seq2,
-			   size_t start2, bool isExtendFwd,
-			   const const_dbl_ptr *substitutionProbs,
-			   const GapCosts &gapCosts, int globality) {
+#endif
+
+  double Centroid::MCF_SIMD_NAME(forward)(BigPtr seq1, const uchar *seq2,
+					  size_t start2, bool isExtendFwd,
+					  const const_dbl_ptr *substitutionProbs,
+					  const GapCosts &gapCosts,
+					  int globality) {
+#if MCF_SIMD_DISPATCH
+    if (simdTier() > 0) {
+      return forwardAvx2(seq1, seq2, start2, isExtendFwd, substitutionProbs,
+			 gapCosts, globality);
+    }
+#endif
+
     seq2ptr = seq2;
     pssmPtr = pssmExp.empty() ? 0 : pssmExp2 + start2;
     const int seqIncrement = isExtendFwd ? 1 : -1;
@@ -95,6 +151,11 @@ namespace cbrc{
     double sumOfProbRatios = 0;
     double logSumOfProbRatios = 0;
 
+    const SimdDbl delInitV = simdFillDbl(delInit);
+    const SimdDbl delNextV = simdFillDbl(delNext);
+    const SimdDbl insInitV = simdFillDbl(insInit);
+    const SimdDbl insNextV = simdFillDbl(insNext);
+
     while (1) {
       double *fM0 = &fM[thisPos];
       double *fD0 = &fD[thisPos];
@@ -113,9 +174,32 @@ namespace cbrc{
       const int numCells = nextPos - thisPos;
       const uchar *s1 = seq1ptr;
 
+      // Do simdDblLen cells at a time, then the leftover cells one by one
+      SimdDbl sumV = simdZeroDbl();
+      int i = 0;
+      for (; i <= numCells - simdDblLen; i += simdDblLen) {
+	const SimdDbl matchProb =
+	  pssmPtr ? matchProbsV(pssmPtr - i * seqIncrement, s1 + i,
+				seqIncrement)
+	  : matchProbsV(substitutionProbs, s1 + i,
+			seq2ptr - i * seqIncrement, seqIncrement);
+	const SimdDbl xD = simdLoadDbl(fD1 + i);
+	const SimdDbl xI = simdLoadDbl(fI1 + i);
+	const SimdDbl xSum = simdAddDbl(simdAddDbl(simdLoadDbl(fM2 + i), xD),
+					xI);
+	simdStoreDbl(fD0 + i, simdAddDbl(simdMulDbl(xSum, delInitV),
+					 simdMulDbl(xD, delNextV)));
+	simdStoreDbl(fI0 + i, simdAddDbl(simdMulDbl(xSum, insInitV),
+					 simdMulDbl(xI, insNextV)));
+	simdStoreDbl(fM0 + i, simdMulDbl(xSum, matchProb));
+	sumV = simdAddDbl(sumV, xSum);
+      }
+      sumOfProbRatios += simdHorizontalAddDbl(sumV);
+      s1 += i;
+
       if (!pssmPtr) {
-	const uchar *s2 = seq2ptr;
-	for (int i = 0; i < numCells; ++i) {
+	const uchar *s2 = seq2ptr - i * seqIncrement;
+	for (; i < numCells; ++i) {
 	  const double matchProb = substitutionProbs[*s1][*s2];
 	  const double xD = fD1[i];
 	  const double xI = fI1[i];
@@ -128,8 +212,8 @@ namespace cbrc{
 	  s2 -= seqIncrement;
 	}
       } else {
-	const ExpMatrixRow *p2 = pssmPtr;
-	for (int i = 0; i < numCells; ++i) {
+	const ExpMatrixRow *p2 = pssmPtr - i * seqIncrement;
+	for (; i < numCells; ++i) {
 	  const double matchProb = (*p2)[*s1];
 	  const double xD = fD1[i];
 	  const double xI = fI1[i];
@@ -190,9 +274,17 @@ namespace cbrc{
 
   // added by M. Hamada
   // compute posterior probabilities while executing backward algorithm
-  void Centroid::backward(bool isExtendFwd,
-			  const const_dbl_ptr *substitutionProbs,
-			  const GapCosts& gapCosts, int globality) {
+  void Centroid::MCF_SIMD_NAME(backward)(bool isExtendFwd,
+					 const const_dbl_ptr *substitutionProbs,
+					 const GapCosts& gapCosts,
+					 int globality) {
+#if MCF_SIMD_DISPATCH
+    if (simdTier() > 0) {
+      backwardAvx2(isExtendFwd, substitutionProbs, gapCosts, globality);
+      return;
+    }
+#endif
+
     const int seqIncrement = isExtendFwd ? 1 : -1;
 
     const double delInit = gapCosts.delProbPieces[0].openProb;
@@ -206,6 +298,11 @@ namespace cbrc{
     initBackward(oldPos);
     double scaledUnit = 1 / rescaledSumOfProbRatios;
 
+    const SimdDbl delInitV = simdFillDbl(delInit);
+    const SimdDbl delNextV = simdFillDbl(delNext);
+    const SimdDbl insInitV = simdFillDbl(insInit);
+    const SimdDbl insNextV = simdFillDbl(insNext);
+
     while (1) {
       const size_t newPos = xa.scoreEndIndex(antidiagonal);
       const double *bM0 = &bM[newPos + xdropPadLen];
@@ -231,10 +328,44 @@ namespace cbrc{
       // !!! careful: values written into pad cells may be wrong
       // !!! (overwrite each other, wrong scaling)
 
+      // With globality, cells get scaledUnit or not depending on
+      // their matchProb, so just do them one by one
+      int i = 0;
+      if (!globality) {
+	const SimdDbl scaledUnitV = simdFillDbl(scaledUnit);
+	for (; i <= numCells - simdDblLen; i += simdDblLen) {
+	  const SimdDbl matchProb =
+	    pssmPtr ? matchProbsV(pssmPtr - i * seqIncrement, s1 + i,
+				  seqIncrement)
+	    : matchProbsV(substitutionProbs, s1 + i,
+			  seq2ptr - i * seqIncrement, seqIncrement);
+	  const SimdDbl yM = simdLoadDbl(bM0 + i);
+	  const SimdDbl yD = simdLoadDbl(bD0 + i);
+	  const SimdDbl yI = simdLoadDbl(bI0 + i);
+	  SimdDbl ySum = simdAddDbl(simdAddDbl(simdMulDbl(yM, matchProb),
+					       simdMulDbl(yD, delInitV)),
+				    simdMulDbl(yI, insInitV));
+	  ySum = simdAddDbl(ySum, scaledUnitV);
+	  simdStoreDbl(bM2 + i, ySum);
+	  simdStoreDbl(bD1 + i, simdAddDbl(ySum, simdMulDbl(yD, delNextV)));
+	  simdStoreDbl(bI1 + i, simdAddDbl(ySum, simdMulDbl(yI, insNextV)));
+	  simdStoreDbl(mDout + i, simdAddDbl(simdLoadDbl(mDout + i),
+					     simdMulDbl(simdLoadDbl(fD0 + i),
+							yD)));
+	}
+	// mI goes backwards, so update it one by one
+	for (int j = 0; j < i; ++j) {
+	  mIout[-j] += fI0[j] * bI0[j];
+	}
+	s1 += i;
+	mDout += i;
+	mIout -= i;
+      }
+
       if (!pssmPtr) {
-	const uchar *s2 = seq2ptr;
+	const uchar *s2 = seq2ptr - i * seqIncrement;
 
-	for (int i = 0; i < numCells; ++i) {
+	for (; i < numCells; ++i) {
 	  const double matchProb = substitutionProbs[*s1][*s2];
 	  const double yM = bM0[i];
 	  const double yD = bD0[i];
@@ -257,9 +388,9 @@ namespace cbrc{
 	  s2 -= seqIncrement;
 	}
       } else {
-	const ExpMatrixRow *p2 = pssmPtr;
+	const ExpMatrixRow *p2 = pssmPtr - i * seqIncrement;
 
-	for (int i = 0; i < numCells; ++i) {
+	for (; i < numCells; ++i) {
 	  const double matchProb = (*p2)[*s1];
 	  const double yM = bM0[i];
 	  const double yD = bD0[i];
@@ -304,6 +435,8 @@ namespace cbrc{
     }
   }
 
+#if !defined MCF_SIMD_TIER
+
   double Centroid::dp_centroid( double gamma ){
     for( size_t k = 1; k < numAntidiagonals; ++k ){  // loop over antidiagonals
       const size_t scoreEnd = xa.scoreEndIndex( k );
@@ -610,4 +743,6 @@ namespace cbrc{
     transitionCounts[4] += insCount - insNextCount;  // insert open/close count
   }
 
+#endif
+
 }  // end namespace cbrc
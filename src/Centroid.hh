@@ -140,6 +140,16 @@ namespace cbrc{
     size_t bestAntiDiagonal;
     size_t bestPos1;
 
+    // Versions of forward and backward compiled for AVX2
+    double forwardAvx2(BigPtr seq1, const uchar *seq2, size_t start2,
+		       bool isExtendFwd,
+		       const const_dbl_ptr *substitutionProbs,
+		       const GapCosts &gapCosts, int globality);
+
+    void backwardAvx2(bool isExtendFwd,
+		      const const_dbl_ptr *substitutionProbs,
+		      const GapCosts &gapCosts, int globality);
+
     void initForward() {
       numAntidiagonals = xa.numAntidiagonals();
       assert(numAntidiagonals > 0);
@@ -0,0 +1,416 @@
+const struct {
+  const char *nickname;
+  const char *realname;
+} subsetSeedNicknames [] = {
+{"RY128", "RY128-12"},
+{"RY16", "RY16-11"},
+{"RY32", "RY32-12"},
+{"RY4", "RY4-9"},
+{"RY64", "RY64-13"},
+{"RY8", "RY8-10"},
+};
+
+const struct {
+  const char *name;
+  const char *text;
+} subsetSeeds[] = {
+{"BISF", "\
+#lastdb -w2\n\
+#lastal -R10 -pBISF\n\
+1  CT A G\n\
+0  ACGT\n\
+1111110101100\n\
+"},
+
+{"BISR", "\
+#lastdb -w2\n\
+#lastal -R10 -pBISR\n\
+1  AG C T\n\
+0  ACGT\n\
+1111110101100\n\
+"},
+
+{"MAM4", "\
+1  A C G T\n\
+0  ACGT\n\
+T  AG CT\n\
+11100TT01T00T10TTTT\n\
+TTTT110TT0T001T0T1T1\n\
+11TT010T01TT0001T\n\
+11TT10T1T101TT\n\
+"},
+
+{"MAM8", "\
+1  A C G T\n\
+0  ACGT\n\
+T  AG CT\n\
+1101T1T0T1T00TT1TT\n\
+1TTTTT010TT0TT01011TTT\n\
+1TTTT10010T011T0TTTT1\n\
+111T011T0T01T100\n\
+1T10T100TT01000TT01TT11\n\
+111T101TT000T0T10T00T1T\n\
+111100T011TTT00T0TT01T\n\
+1T1T10T1101101\n\
+"},
+
+{"MURPHY10", "\
+#lastdb -p\n\
+1  ILMV FWY A C G H P KR ST DENQ\n\
+1\n\
+"},
+
+{"NEAR", "\
+#lastal -r6 -q18 -a21 -b9\n\
+1  A C G T\n\
+0  ACGT\n\
+1111110\n\
+"},
+
+{"PSEUDO", "\
+1  A C D E F G H I K L M N P Q R S T V W Y *\n\
+0  ACDEFGHIKLMNPQRSTVWY*\n\
+2  ACST DEN FHWY G KQR* P ILMV\n\
+1120\n\
+"},
+
+{"RY128-12", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRRRYYRYY RRYRRYYYYYYY\n\
+RRRRRRYYYRYY RRYRRRYYYYYY\n\
+RRRRRYRYYRYY RRYRRYRYYYYY\n\
+RRRRRYYRYRYY RRYRYRRYYYYY\n\
+RRRRRYYYYRYY RRYRRRRYYYYY\n\
+RRRRYRYYYRYY RRYRRRYRYYYY\n\
+RRRRYYYRRYYY RRRYYRRRYYYY\n\
+RRRRYYYRYRYY RRYRYRRRYYYY\n\
+RRRYRRRYYRYY RRYRRYYYRYYY\n\
+RRRYRYRYYRYY RRYRRYRYRYYY\n\
+RRRYRYYRRYYY RRRYYRRYRYYY\n\
+RRRYRYYRYRYY RRYRYRRYRYYY\n\
+RRRYYRRYYRYY RRYRRYYRRYYY\n\
+RRRYYRYRYRYY RRYRYRYRRYYY\n\
+RRYRRRRYYRYY RRYRRYYYYRYY\n\
+RRYRRYYRYRYY RRYRYRRYYRYY\n\
+"},
+
+{"RY16-11", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRYRYRRRRRR RRYRYRRRRYR RRYRYRRRYRR RRYRYRRYRRR\n\
+RRYRYRRYRRY RRYRYRYRRRR RRYRYRYRRYR RRYRYRYRYRR\n\
+RRYRYRYYRRR RRYRYRYYRRY RRYRYYRRRRR RRYRYYRRRYR\n\
+RRYRYYRRYRR RRYRYYRYRRY RRYRYYYRRRR RRYRYYYRRYR\n\
+RRYRYYYRYRR RRYRYYYYRRR RRYRYYYYRRY RRYYRRRRRRR\n\
+RRYYRRRRRRY RRYYRRRRRYR RRYYRRRRYRR RRYYRRRYRRR\n\
+RRYYRRRYRRY RRYYRRYRRRR RRYYRRYRRRY RRYYRRYRRYR\n\
+RRYYRYRRRRR RRYYRYRRRRY RRYYRYRRRYR RRYYRYRRYRR\n\
+RRYYRYRYRRR RRYYRYRYRRY RRYYRYRYYRR RRYYRYYRRRR\n\
+RRYYRYYRRRY RRYYRYYRRYR RRYYRYYYRRR RRYYRYYYRRY\n\
+RRYYRYYYYRR RRYYYRRRRRR RRYYYRRRRRY RRYYYRRRRYR\n\
+RRYYYRRRYRR RRYYYRRYRRR RRYYYRRYRRY RRYYYRYRRRR\n\
+RRYYYRYRRRY RRYYYRYRRYR RRYYYRYYRRR RRYYYRYYRRY\n\
+RRYYYRYYYRR RRYYYYRRRRR RRYYYYRRRRY RRYYYYRRRYR\n\
+RRYYYYRRYRR RRYYYYRYRRR RRYYYYRYRRY RRYYYYRYYRR\n\
+RRYYYYYRRRR RRYYYYYRRRY RRYYYYYRRYR RRYYYYYRYRR\n\
+RRYYYYYYRRY RYRYRYRYYRR RYRYRYYYRRR RYRYRYYYRRY\n\
+RYRYRYYYYRR RYRYYRYRRRR RYRYYRYRRRY RYRYYRYRYRR\n\
+RYRYYRYYRRR RYRYYRYYRRY RYRYYRYYYRR RYRYYYRYYRR\n\
+RYRYYYYRYRR RYRYYYYYRRR RYRYYYYYRRY RYYRYYRYRRR\n\
+RYYRYYRYRRY RYYRYYYRYRR RYYYRYRYRRR RYYYRYRYRRY\n\
+RYYYRYRYYRR RYYYRYYRYRR RYYYYRYRYRR RYYYYYRYYRR\n\
+RYYYYYYRRRR RYYYYYYRRRY RYYYYYYRYRR RYYYYYYYRRR\n\
+RYYYYYYYRRY RYYYYYYYYRR YRYRYRYRYRR YRYRYYRYRRY\n\
+YRYRYYYRYRR YRYYRYRYYRR YRYYRYYYYRR YRYYYRYYYRR\n\
+YRYYYYRYYRR YRYYYYYRYRR YRYYYYYYRRY YYRYRYRYRRR\n\
+YYRYRYRYRRY YYRYRYRYYRR YYRYRYYYRRR YYRYRYYYRRY\n\
+YYRYRYYYYRR YYRYYRYRYRR YYRYYRYYRRR YYRYYRYYRRY\n\
+YYRYYRYYYRR YYRYYYRYYRR YYRYYYYRYRR YYRYYYYYRRR\n\
+YYRYYYYYRRY YYYRYYYRYRR YYYRYYYYRRR YYYRYYYYRRY\n\
+YYYYRYRYYRR YYYYRYYRYRR YYYYRYYYRRR YYYYRYYYRRY\n\
+YYYYYRYRYRR YYYYYYRYYRR YYYYYYYRYRR YYYYYYYYYRR\n\
+"},
+
+{"RY16-8", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRYRY\n\
+RRRRYYRY\n\
+RRRYYYRY\n\
+RRRYYYYY\n\
+RRYRRYRY\n\
+RRYYYYRY\n\
+YRRRRYRY\n\
+YRRRYRYR\n\
+YRRRYRYY\n\
+YRRRYYRY\n\
+YRRYYRYR\n\
+YRRYYRYY\n\
+YRRYYYRY\n\
+YRRYYYYY\n\
+YYRRYRYR\n\
+YYRRYRYY\n\
+"},
+
+{"RY32-10", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+YRRYRRYRRR\n\
+YRRYRYYRRR\n\
+YRRYYRYRRR\n\
+YRRYYYRRRR\n\
+YRRYYYRRRY\n\
+YRRYYYYRRR\n\
+YRYRRYRRRR\n\
+YRYRRYRRRY\n\
+YRYRRYYRRR\n\
+YRYRYRYRRR\n\
+YRYRYYRRRR\n\
+YRYRYYRRRY\n\
+YRYRYYYRRR\n\
+YRYYRRYRRR\n\
+YRYYRYYRRR\n\
+YRYYYRYRRR\n\
+YRYYYYRRRR\n\
+YRYYYYRRRY\n\
+YRYYYYYRRR\n\
+YYRRYRYRRR\n\
+YYRRYYRRRR\n\
+YYRRYYRRRY\n\
+YYRYRYRRRR\n\
+YYRYYRYRRR\n\
+YYRYYYRRRR\n\
+YYRYYYRRRY\n\
+YYYRYYRRRR\n\
+YYYRYYRRRY\n\
+YYYYRRYRRR\n\
+YYYYYRYRRR\n\
+YYYYYYRRRR\n\
+YYYYYYRRRY\n\
+"},
+
+{"RY32-12", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRRRRYYYR RRRRRRRRYYYY RRRRRRYRRYYY RRRRRRYRYYYR\n\
+RRRRRYRRRYYY RRRRRYRYYYYR RRRRRYRYYYYY RRRRRYYRYYYR\n\
+RRRRRYYRYYYY RRRRYRYRRYYY RRRRYRYRYYYR RRRRYRYRYYYY\n\
+RRRRYRYYRYYY RRRRYYRRYYYR RRRRYYRRYYYY RRRRYYRYRYYY\n\
+RRRYRRRRYYYR RRRYRRRRYYYY RRRYRRYRYYYR RRRYRRYRYYYY\n\
+RRRYYRRRRYYY RRRYYRRRYYYR RRRYYRYRRYYY RRRYYRYYRYYY\n\
+RRYRRRRRRYYY RRYRRRRRYYYR RRYRRRYRYYYR RRYRRRYRYYYY\n\
+RRYRRRYYRYYY RRYRRYRRRYYY RRYRRYRRYYYR RRYRRYRRYYYY\n\
+RRYRRYYRRYYY RRYRRYYRYYYR RRYRRYYRYYYY RRYRYRRRRYYY\n\
+RRYRYRRRYYYR RRYRYRRRYYYY RRYRYRRYRYYY RRYRYRYRRYYY\n\
+RRYRYRYRYYYR RRYRYRYRYYYY RRYRYYRRRYYY RRYRYYRRYYYR\n\
+RRYRYYRRYYYY RRYYRRRRRYYY RRYYRRRYRYYY RRYYRRRYYYYR\n\
+RRYYRRRYYYYY RRYYRRYRYYYR RRYYRRYRYYYY RRYYRYRYRYYY\n\
+RRYYRYYRRYYY RYRRRRRRRYYY RYRRRRRYYYYR RYRRRRRYYYYY\n\
+RYRRRRYRRYYY RYRRRRYRYYYR RYRRRRYRYYYY RYRRRRYYRYYY\n\
+RYRRRYRRRYYY RYRRRYRRYYYR RYRRRYRRYYYY RYRRRYRYRYYY\n\
+RYRRRYYRRYYY RYRRYRRRRYYY RYRRYRRYRYYY RYRRYRYRRYYY\n\
+RYRRYRYRYYYR RYRRYRYRYYYY RYRRYRYYRYYY RYRRYYRYRYYY\n\
+RYRYRRRYRYYY RYRYRRYRRYYY RYRYRRYYRYYY RYRYRYRRRYYY\n\
+RYRYRYRYRYYY RYRYRYYRRYYY RYRYRYYRYYYR RYRYRYYRYYYY\n\
+RYRYYRRRRYYY RYRYYRRYRYYY RYRYYRYRRYYY RYRYYRYRYYYR\n\
+RYRYYRYRYYYY RYRYYRYYRYYY RYYRRRRRRYYY RYYRRRRYRYYY\n\
+RYYRRRYRRYYY RYYRRRYYRYYY RYYRRYRRRYYY RYYRRYRRYYYR\n\
+RYYRRYRRYYYY RYYRRYRYRYYY RYYRRYYRRYYY RYYRRYYRYYYR\n\
+RYYRRYYRYYYY RYYRYRRRRYYY RYYRYRRRYYYR RYYRYRRRYYYY\n\
+RYYRYRRYRYYY RYYRYRYRRYYY RYYRYRYYRYYY RYYRYYRRRYYY\n\
+RYYRYYRYRYYY YRRRRRYRRYYY YRRRRRYRYYYR YRRRRYRRRYYY\n\
+YRRRYRYRRYYY YRRRYRYYRYYY YRRRYYRYRYYY YRRYYRRRRYYY\n\
+YRRYYRRRYYYR YRRYYRYRRYYY YRRYYRYYRYYY YRYRRRRRRYYY\n\
+YRYRRRRRYYYR YRYRRRYYRYYY YRYRRYRRRYYY YRYRRYYRRYYY\n\
+YRYRYRRRRYYY YRYRYRRYRYYY YRYRYRYRRYYY YRYRYYRRRYYY\n\
+YRYYRRRRRYYY YRYYRRRYRYYY YRYYRYRYRYYY YRYYRYYRRYYY\n\
+"},
+
+{"RY4-6", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRY\n\
+RRYRRY\n\
+RRYRYY\n\
+RYRRRR\n\
+RYRRRY\n\
+RYRYRY\n\
+RYYRRR\n\
+RYYRRY\n\
+RYYRYR\n\
+RYYRYY\n\
+RYYYRY\n\
+RYYYYY\n\
+YRYRRY\n\
+YYYRRR\n\
+YYYRRY\n\
+YYYYRY\n\
+"},
+
+{"RY4-9", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRRRRY RRRRRRYRY RRRRRYRRR RRRRRYRRY\n\
+RRRRRYYRR RRRRRYYRY RRRRRYYYR RRRRRYYYY\n\
+RRRYRYRRR RRRYRYRRY RRRYRYYRR RRRYRYYRY\n\
+RRRYRYYYR RRRYRYYYY RRYRRRRRR RRYRRRRRY\n\
+RRYRRRYRY RRYRRYRRR RRYRRYRRY RRYRRYRYR\n\
+RRYRRYYRR RRYRRYYRY RRYRRYYYY RRYRYRYRY\n\
+RRYYRYRRR RRYYRYRRY RRYYRYYRY RRYYRYYYY\n\
+RRYYYYRRR RRYYYYRRY RRYYYYRYR RRYYYYYRR\n\
+RYRRRRYRR RYRRRRYRY RYRRRRYYR RYRRRRYYY\n\
+RYRRRYRRR RYRRRYRRY RYRRRYYRR RYRRRYYRY\n\
+RYRRRYYYR RYRRRYYYY RYRRYRYYR RYRRYRYYY\n\
+RYRRYYYRR RYRRYYYRY RYRYRYRRR RYRYRYRRY\n\
+RYRYRYYRR RYRYRYYRY RYRYRYYYR RYRYRYYYY\n\
+RYYRRRRRR RYYRRRRRY RYYRRRRYR RYYRRRYRR\n\
+RYYRRRYRY RYYRRRYYR RYYRRRYYY RYYRRYRRR\n\
+RYYRRYRRY RYYRRYRYR RYYRRYYRR RYYRRYYRY\n\
+RYYRRYYYR RYYRRYYYY RYYRYRYRR RYYRYRYRY\n\
+RYYRYRYYR RYYRYRYYY RYYRYYRRR RYYRYYRRY\n\
+RYYRYYYRR RYYRYYYRY RYYYRYRRR RYYYRYRRY\n\
+RYYYRYYRR RYYYRYYRY RYYYRYYYR RYYYRYYYY\n\
+RYYYYRYYR RYYYYRYYY RYYYYYRYR RYYYYYYRR\n\
+RYYYYYYYY YRYRRRRRR YRYRRRRRY YRYRRRYRY\n\
+YRYRRYRRR YRYRRYRRY YRYRRYRYR YRYRRYYRR\n\
+YRYRRYYRY YRYRRYYYY YRYYRYRRR YRYYRYRRY\n\
+YRYYRYYRY YRYYRYYYY YRYYYYRRR YRYYYYRRY\n\
+YRYYYYRYR YRYYYYYRR YYRRRRYYR YYRRRRYYY\n\
+YYRRYRYYR YYRRYRYYY YYYRRRRRR YYYRRRRRY\n\
+YYYRRRRYR YYYRRRYRR YYYRRRYRY YYYRRRYYR\n\
+YYYRRRYYY YYYRRYRRR YYYRRYRRY YYYRRYRYR\n\
+YYYRRYYRR YYYRRYYRY YYYRRYYYR YYYRRYYYY\n\
+YYYRYRYRR YYYRYRYRY YYYRYRYYR YYYRYRYYY\n\
+YYYYYRYYR YYYYYRYYY YYYYYYRYR YYYYYYYRR\n\
+"},
+
+{"RY64-13", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRRRRRRYYY RRRRRRRRYRYYY RRRRRRYRRYYYY RRRRRRYRYRYYY\n\
+RRRRRRYYRYYYY RRRRRYRRRRYYY RRRRRYYRRRYYY RRRRRYYRRYYYY\n\
+RRRRRYYRYRYYY RRRRYRRRRRYYY RRRRYRRRYRYYY RRRRYRRYRRYYY\n\
+RRRRYRRYRYYYY RRRRYRYRRRYYY RRRRYRYYRYYYY RRRRYYRRRRYYY\n\
+RRRRYYRRYRYYY RRRRYYRYRRYYY RRRYRRRYRRYYY RRRYRRRYYRYYY\n\
+RRRYRRYRYRYYY RRRYRRYYRRYYY RRRYRRYYRYYYY RRRYRYRRYRYYY\n\
+RRRYRYRYRRYYY RRRYRYRYRYYYY RRRYRYRYYRYYY RRRYYRYRYRYYY\n\
+RRYRRRRYRYYYY RRYRRRRYYRYYY RRYRRRYRYRYYY RRYRRYRRRRYYY\n\
+RRYRRYRRRYYYY RRYRYRRRRRYYY RRYRYRRRRYYYY RRYRYRRRYRYYY\n\
+RRYRYRRYRRYYY RRYRYYRRRYYYY RRYRYYRRYYYYY RRYRYYRYRRYYY\n\
+RRYRYYRYRYYYY RRYRYYRYYRYYY RRYYRRRRYRYYY RRYYRRRYRYYYY\n\
+RRYYRRRYYRYYY RRYYRRYRRRYYY RRYYRRYRRYYYY RRYYRYRRRRYYY\n\
+RRYYRYRYRRYYY RRYYRYRYYRYYY RYRRRRRRRRYYY RYRRRRRRRYYYY\n\
+RYRRRRRRYRYYY RYRRRRRYRRYYY RYRRRRRYRYYYY RYRRRRRYYRYYY\n\
+RYRRRRYRRYYYY RYRRRRYRYRYYY RYRRRRYYRRYYY RYRRRYRRRRYYY\n\
+RYRRRYRRRYYYY RYRRRYRRYRYYY RYRRRYRYRRYYY RYRRRYYRRRYYY\n\
+RYRRRYYRRYYYY RYRRRYYRYRYYY RYRRYRRRRRYYY RYRRYRRRYRYYY\n\
+RYRRYRRYRYYYY RYRRYRRYYRYYY RYRRYRYRRRYYY RYRRYRYRRYYYY\n\
+RYRRYRYRYRYYY RYRRYRYYRYYYY RYRRYYRRRRYYY RYRRYYRRRYYYY\n\
+RYRRYYRRYRYYY RYRRYYRYRRYYY RYRRYYRYRYYYY RYRRYYRYYRYYY\n\
+RYRYRRRRRRYYY RYRYRRRRYRYYY RYRYRRRYRRYYY RYRYRRRYYRYYY\n\
+RYRYRRYRRRYYY RYRYRRYRYRYYY RYRYRRYYRRYYY RYRYRYRRRYYYY\n\
+RYRYRYRYRRYYY RYRYRYRYRYYYY RYRYRYRYYRYYY RYRYRYYRRRYYY\n\
+RYRYRYYRRYYYY RYRYRYYRYRYYY RYRYYRRRRYYYY RYRYYRRRYRYYY\n\
+RYRYYRRYRRYYY RYRYYRRYYRYYY RYRYYRYRRRYYY RYRYYRYYRRYYY\n\
+RYYRRRRRRRYYY RYYRRRRRRYYYY RYYRRRRRYRYYY RYYRRRRRYYYYY\n\
+RYYRRRRYYRYYY RYYRRRYRRRYYY RYYRRRYRRYYYY RYYRRRYRYRYYY\n\
+RYYRRRYYRRYYY RYYRRYRRRRYYY RYYRRYRRYRYYY RYYRRYRYRRYYY\n\
+RYYRRYRYRYYYY RYYRRYRYYRYYY RYYRRYYRRYYYY RYYRRYYRYRYYY\n\
+RYYRYRRRRRYYY RYYRYRRRYRYYY RYYRYRRYRRYYY RYYRYRRYRYYYY\n\
+RYYRYRRYYRYYY RYYRYRYRRRYYY RYYRYRYRYRYYY RYYRYYRRRRYYY\n\
+RYYRYYRRYRYYY RYYRYYRYRRYYY RYYRYYRYRYYYY RYYRYYRYYRYYY\n\
+"},
+
+{"RY8-10", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRYRRRRY RRRRYRRRYR RRRRYRRRYY RRRRYRYRRY\n\
+RRRRYRYRYY RRRRYYRRYY RRRRYYYRYY RRRYRRRRRR\n\
+RRRYRRRRRY RRRYRRYRRY RRRYRRYRYY RRRYYRRRRY\n\
+RRRYYRRRYR RRRYYRRRYY RRRYYRRYRY RRRYYRYRRY\n\
+RRRYYRYRYY RRRYYYRRRR RRRYYYRRRY RRRYYYRRYY\n\
+RRRYYYYRYY RRYRYRRRRR RRYRYRRRRY RRYRYRRRYR\n\
+RRYRYRRRYY RRYRYRYRRR RRYRYRYRRY RRYRYRYRYR\n\
+RRYRYRYRYY RRYRYYRRYY RRYRYYYRYY RRYYRRRRRY\n\
+RRYYRRYRRR RRYYRRYRRY RRYYRYRRRR RRYYRYRRRY\n\
+RRYYRYRYRR RRYYRYRYRY RRYYRYYRYY RRYYYRRYRR\n\
+RRYYYRRYRY RRYYYRYRRY RRYYYRYRYY RRYYYYRRRR\n\
+RRYYYYRRRY RRYYYYRRYR RRYYYYRRYY RRYYYYRYRR\n\
+RRYYYYRYRY RRYYYYYRRY RRYYYYYRYY RRYYYYYYRY\n\
+RYRRYRRRRR RYRRYRRRRY RYRRYRRRYR RYRRYRRRYY\n\
+RYRRYRYRRY RYRRYRYRYY RYRRYYRRYY RYRRYYYRYY\n\
+RYRYYRRRRY RYRYYRRRYR RYRYYRRRYY RYRYYRRYRY\n\
+RYRYYRYRRY RYRYYRYRYY RYRYYYRRYY RYRYYYYRYY\n\
+RYYRRRRRRR RYYRRRRRRY RYYRYYRRYY RYYRYYYRYY\n\
+RYYYRYRRRR RYYYRYRRRY RYYYRYRYRR RYYYRYRYRY\n\
+RYYYYYRRRR RYYYYYRRRY RYYYYYRYRR RYYYYYRYRY\n\
+RYYYYYYRRR RYYYYYYRRY RYYYYYYYRY YRRYYRRRRY\n\
+YRRYYRRRYR YRRYYRRRYY YRRYYRRYRY YRRYYRYRRY\n\
+YRRYYRYRYY YRRYYYRRRR YRRYYYRRRY YRRYYYRRYY\n\
+YRRYYYYRYY YRYYRRRRRY YRYYRRYRRR YRYYRRYRRY\n\
+YRYYRYRRRR YRYYRYRRRY YRYYRYRYRR YRYYRYRYRY\n\
+YRYYYRRRRR YRYYYRRRRY YRYYYRRRYR YRYYYRRRYY\n\
+YRYYYRRYRR YRYYYRRYRY YRYYYRYRRY YRYYYRYRYY\n\
+YRYYYYRRRR YRYYYYRRRY YRYYYYRRYR YRYYYYRRYY\n\
+YRYYYYRYRR YRYYYYRYRY YRYYYYYRRY YRYYYYYRYY\n\
+YRYYYYYYRY YYRYYRRRRY YYRYYRRRYR YYRYYRRRYY\n\
+YYRYYRRYRY YYRYYRYRRY YYRYYRYRYY YYRYYYRRYY\n\
+YYRYYYYRYY YYYYYYYRRR YYYYYYYRRY YYYYYYYYRY\n\
+"},
+
+{"RY8-8", "\
+#lastal -m2\n\
+R  A G\n\
+Y  C T\n\
+RRRRRRRY\n\
+RRYRRRYY\n\
+RYRRRRYR\n\
+RYRRRRYY\n\
+RYRRRYRY\n\
+YRRRRRRY\n\
+YRRRRRYR\n\
+YRRRRRYY\n\
+YRRRYRRY\n\
+YRRYRRYR\n\
+YRRYRRYY\n\
+YRYRRRYY\n\
+YRYRRYRY\n\
+YRYRRYYR\n\
+YRYRRYYY\n\
+YRYRYRYY\n\
+YYRRRRYR\n\
+YYRRRRYY\n\
+YYRRRYRY\n\
+YYRRRYYR\n\
+YYRRRYYY\n\
+YYRRYRYR\n\
+YYRRYRYY\n\
+YYRRYYRY\n\
+YYRRYYYR\n\
+YYRRYYYY\n\
+YYRYRYYR\n\
+YYRYRYYY\n\
+YYRYYRYY\n\
+YYYRYYYR\n\
+YYYRYYYY\n\
+YYYYYYYR\n\
+"},
+
+{"YASS", "\
+1  A C G T\n\
+0  ACGT\n\
+T  AG CT\n\
+1T1001100101\n\
+"},
+
+};
@@ -9,49 +9,82 @@
 // covered so far in each diagonal.  This lets us avoid triggering
 // gapless alignments in places that are already covered.
 
-// Since the number of diagonals may be huge, we map them to a smaller
-// number of bins.  To keep the bin populations small, when checking
-// if a position is covered, we discard information about earlier
-// sequential positions.
+// The diagonals are kept in an open-addressing hash table, with
+// linear probing.  When checking if a position is covered, entries
+// ending before that sequential position expire: their slots can be
+// reused, and they are dropped when the table is rebuilt.
 
 #ifndef DIAGONALTABLE_HH
 #define DIAGONALTABLE_HH
 
 #include <stddef.h>
-#include <utility>  // pair
+#include <stdint.h>
 #include <vector>
 
 namespace cbrc {
 
 struct DiagonalTable {
 
-  typedef std::pair<size_t, size_t> pairT;
+  struct Slot {
+    size_t diagonal;
+    size_t end;  // 1 + furthest covered position, or 0 if never used
+  };
 
-  enum { BINS = 256 };  // use a power-of-two for faster modulus (maybe)
-                        // 256 is much faster than 65536 in my tests
+  enum { MIN_BITS = 8 };
+
+  DiagonalTable() : minEnd(1), usedSlotCount(0), bits(0) {}
 
   // is this position on this diagonal already covered by an alignment?
   bool isCovered(size_t diagonal, size_t sequentialPos) {
-    std::vector<pairT> &v = hits[diagonal % BINS];
-
-    for (std::vector<pairT>::iterator i = v.begin(); i < v.end(); ) {
-      if (i->first >= sequentialPos) {
-	if (i->second == diagonal) return true;
-	++i;
-      } else {
-	i = v.erase(i);  // hopefully we rarely get here
-      }
+    minEnd = sequentialPos + 1;  // entries ending before this expire
+    if (slots.empty()) return false;
+    size_t mask = slots.size() - 1;
+    for (size_t i = slotNum(diagonal); ; i = (i + 1) & mask) {
+      const Slot &s = slots[i];
+      if (s.end == 0) return false;
+      if (s.diagonal == diagonal && s.end >= minEnd) return true;
     }
-
-    return false;
   }
 
-  // add an alignment endpoint to the table:
+  // add an alignment endpoint to the table.  This should be for a
+  // diagonal that isn't covered at the latest isCovered position.
   void addEndpoint(size_t diagonal, size_t sequentialPos) {
-    hits[diagonal % BINS].push_back(pairT(sequentialPos, diagonal));
+    if (usedSlotCount * 2 >= slots.size()) rebuild();
+    size_t mask = slots.size() - 1;
+    size_t i = slotNum(diagonal);
+    while (slots[i].end >= minEnd) i = (i + 1) & mask;
+    if (slots[i].end == 0) ++usedSlotCount;
+    slots[i].diagonal = diagonal;
+    slots[i].end = sequentialPos + 1;
+  }
+
+  size_t slotNum(size_t diagonal) const {  // Fibonacci hashing
+    return (uint64_t(diagonal) * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+  }
+
+  // Remake the table with just the unexpired entries, making it big
+  // enough that it's at most 1/4 full
+  void rebuild() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    size_t liveCount = 0;
+    for (size_t i = 0; i < old.size(); ++i) {
+      liveCount += (old[i].end >= minEnd);
+    }
+    if (bits < MIN_BITS) bits = MIN_BITS;
+    while ((size_t(1) << bits) < liveCount * 4) ++bits;
+    Slot empty = {0, 0};
+    slots.assign(size_t(1) << bits, empty);
+    usedSlotCount = 0;
+    for (size_t i = 0; i < old.size(); ++i) {
+      if (old[i].end >= minEnd) addEndpoint(old[i].diagonal, old[i].end - 1);
+    }
   }
 
-  std::vector<pairT> hits[BINS];
+  std::vector<Slot> slots;  // the number of slots is a power of 2
+  size_t minEnd;
+  size_t usedSlotCount;  // number of slots that have ever been used
+  unsigned bits;  // log2 of the number of slots
 };
 
 }
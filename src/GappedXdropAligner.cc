@@ -54,19 +54,42 @@
 
 namespace cbrc {
 
-int GappedXdropAligner::align(BigPtr seq1,
-                              const uchar *seq2,
-                              bool isForward,
-			      int globality,
-                              const ScoreMatrixRow *scorer,
-                              int delExistenceCost,
-                              int delExtensionCost,
-                              int insExistenceCost,
-                              int insExtensionCost,
-                              int gapUnalignedCost,
-			      bool isAffine,
-                              int maxScoreDrop,
-                              int maxMatchScore) {
+#if !defined MCF_SIMD_TIER
+#if MCF_SIMD_DISPATCH
+const int xdropPadLen = simdBytes << simdTier();
+#else
+const int xdropPadLen = simdBytes;
+#endif
+#endif
+
+int GappedXdropAligner::MCF_SIMD_NAME(align)(BigPtr seq1,
+					     const uchar *seq2,
+					     bool isForward,
+					     int globality,
+					     const ScoreMatrixRow *scorer,
+					     int delExistenceCost,
+					     int delExtensionCost,
+					     int insExistenceCost,
+					     int insExtensionCost,
+					     int gapUnalignedCost,
+					     bool isAffine,
+					     int maxScoreDrop,
+					     int maxMatchScore) {
+#if MCF_SIMD_DISPATCH
+  if (simdTier() > 1) {
+    return alignAvx512(seq1, seq2, isForward, globality, scorer,
+		       delExistenceCost, delExtensionCost,
+		       insExistenceCost, insExtensionCost,
+		       gapUnalignedCost, isAffine, maxScoreDrop, maxMatchScore);
+  }
+  if (simdTier() > 0) {
+    return alignAvx2(seq1, seq2, isForward, globality, scorer,
+		     delExistenceCost, delExtensionCost,
+		     insExistenceCost, insExtensionCost,
+		     gapUnalignedCost, isAffine, maxScoreDrop, maxMatchScore);
+  }
+#endif
+
   const SimdInt mNegInf = simdFill(-INF);
   const SimdInt mDelOpenCost = simdFill(delExistenceCost);
   const SimdInt mDelGrowCost = simdFill(delExtensionCost);
@@ -142,6 +165,16 @@ int GappedXdropAligner::align(BigPtr seq1,
 	SimdInt s = simdSet(
 #if defined __SSE4_1__ || defined __ARM_NEON
 #ifdef __AVX2__
+#ifdef __AVX512BW__
+			    s1[15][s2[15]],
+			    s1[14][s2[14]],
+			    s1[13][s2[13]],
+			    s1[12][s2[12]],
+			    s1[11][s2[11]],
+			    s1[10][s2[10]],
+			    s1[9][s2[9]],
+			    s1[8][s2[8]],
+#endif
 			    s1[7][s2[7]],
 			    s1[6][s2[6]],
 			    s1[5][s2[5]],
@@ -229,6 +262,8 @@ int GappedXdropAligner::align(BigPtr seq1,
   return bestScore;
 }
 
+#if !defined MCF_SIMD_TIER
+
 bool GappedXdropAligner::getNextChunk(size_t &end1,
                                       size_t &end2,
                                       size_t &length,
@@ -292,4 +327,6 @@ void GappedXdropAligner::writeShape(std::ostream &out) const {
   }
 }
 
+#endif
+
 }
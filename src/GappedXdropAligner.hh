@@ -52,6 +52,7 @@
 #include "mcf_simd.hh"
 #include "ScoreMatrixRow.hh"
 
+#include <algorithm>
 #include <iosfwd>
 #include <stddef.h>  // size_t
 #include <vector>
@@ -68,7 +69,11 @@ typedef uchar TinyScore;
 
 class TwoQualityScoreMatrix;
 
-const int xdropPadLen = simdBytes;
+// The number of pad cells between antidiagonals.  It is the SIMD
+// width, in bytes, of the widest kernel tier that the CPU can run.
+// All tiers use it, because Centroid and the trace-back share the
+// layout of the score vectors.
+extern const int xdropPadLen;
 
 const int droppedTinyScore = UCHAR_MAX;
 
@@ -233,6 +238,24 @@ class GappedXdropAligner {
   size_t numAntidiagonals() const
   { return numOfAntidiagonals; }
 
+  // Copy the shape of the x-drop region, which is all that Centroid
+  // uses.  Restoring a copied shape lets Centroid run on an old
+  // extension, without redoing its dynamic programming.
+  void getShape(std::vector<size_t> &shape) const {
+    size_t n = std::min(2 * (numOfAntidiagonals + 2) + 1,
+			scoreEndsAndOrigins.size());
+    shape.assign(scoreEndsAndOrigins.begin(), scoreEndsAndOrigins.begin() + n);
+    shape.push_back(numOfAntidiagonals);
+  }
+
+  void setShape(const std::vector<size_t> &shape) {
+    size_t n = shape.size() - 1;
+    // don't shrink it: alignDna decides when to grow it by other means
+    if (scoreEndsAndOrigins.size() < n) scoreEndsAndOrigins.resize(n);
+    std::copy(shape.begin(), shape.begin() + n, scoreEndsAndOrigins.begin());
+    numOfAntidiagonals = shape[n];
+  }
+
   size_t numCellsAndPads(size_t antidiagonal) const
   { return scoreEndsAndOrigins[2 * (antidiagonal + 3)]
       -    scoreEndsAndOrigins[2 * (antidiagonal + 2)]; }
@@ -290,6 +313,53 @@ class GappedXdropAligner {
   size_t bestAntidiagonal;
   size_t bestSeq1position;
 
+  // Versions of the SIMD kernels compiled for AVX2 and AVX-512BW,
+  // which the baseline versions call according to simdTier()
+  int alignAvx2(BigPtr seq1, const uchar *seq2, bool isForward,
+		int globality, const ScoreMatrixRow *scorer,
+		int delExistenceCost, int delExtensionCost,
+		int insExistenceCost, int insExtensionCost,
+		int gapUnalignedCost, bool isAffine,
+		int maxScoreDrop, int maxMatchScore);
+
+  int alignPssmAvx2(BigPtr seq, const ScoreMatrixRow *pssm,
+		    bool isForward, int globality,
+		    int delExistenceCost, int delExtensionCost,
+		    int insExistenceCost, int insExtensionCost,
+		    int gapUnalignedCost, bool isAffine,
+		    int maxScoreDrop, int maxMatchScore);
+
+  int alignDnaAvx2(BigPtr seq1, const uchar *seq2, bool isForward,
+		   const ScoreMatrixRow *scorer,
+		   int delExistenceCost, int delExtensionCost,
+		   int insExistenceCost, int insExtensionCost,
+		   int maxScoreDrop, int maxMatchScore,
+		   const uchar *toUnmasked);
+
+  int alignAvx512(BigPtr seq1, const uchar *seq2, bool isForward,
+		  int globality, const ScoreMatrixRow *scorer,
+		  int delExistenceCost, int delExtensionCost,
+		  int insExistenceCost, int insExtensionCost,
+		  int gapUnalignedCost, bool isAffine,
+		  int maxScoreDrop, int maxMatchScore);
+
+  int alignPssmAvx512(BigPtr seq, const ScoreMatrixRow *pssm,
+		      bool isForward, int globality,
+		      int delExistenceCost, int delExtensionCost,
+		      int insExistenceCost, int insExtensionCost,
+		      int gapUnalignedCost, bool isAffine,
+		      int maxScoreDrop, int maxMatchScore);
+
+  int alignDnaAvx512(BigPtr seq1, const uchar *seq2, bool isForward,
+		     const ScoreMatrixRow *scorer,
+		     int delExistenceCost, int delExtensionCost,
+		     int insExistenceCost, int insExtensionCost,
+		     int maxScoreDrop, int maxMatchScore,
+		     const uchar *toUnmasked);
+
+  // The inline functions below get compiled into every tier of the
+  // kernels, so they should not depend on the SIMD width.
+
   void resizeScoresIfSmaller(size_t size) {
     if (xScores.size() < size) {
       xScores.resize(size);
@@ -300,7 +370,6 @@ class GappedXdropAligner {
 
   void initAntidiagonal(size_t antidiagonalIncludingDummies,
 			size_t seq1end, size_t thisEnd, int numCells) {
-    const SimdInt mNegInf = simdFill(-INF);
     size_t nextEnd = thisEnd + xdropPadLen + numCells;
 
     size_t a = 2 * (antidiagonalIncludingDummies + 1);
@@ -310,12 +379,10 @@ class GappedXdropAligner {
     scoreEndsAndOrigins[a - 1] = nextEnd - seq1end;
     scoreEndsAndOrigins[a] = nextEnd;
 
-    resizeScoresIfSmaller(nextEnd + (simdLen-1));
-    for (int i = 0; i < xdropPadLen; i += simdLen) {
-      simdStore(&xScores[thisEnd + i], mNegInf);
-      simdStore(&yScores[thisEnd + i], mNegInf);
-      simdStore(&zScores[thisEnd + i], mNegInf);
-    }
+    resizeScoresIfSmaller(nextEnd + xdropPadLen);
+    std::fill_n(&xScores[thisEnd], xdropPadLen, -INF);
+    std::fill_n(&yScores[thisEnd], xdropPadLen, -INF);
+    std::fill_n(&zScores[thisEnd], xdropPadLen, -INF);
   }
 
   // Puts 2 "dummy" antidiagonals at the start, so that we can safely
@@ -370,7 +437,6 @@ class GappedXdropAligner {
 
   void initAntidiagonalTiny(size_t antidiagonalIncludingDummies,
 			    size_t seq1end, size_t thisEnd, int numCells) {
-    const SimdUint1 mNegInf = simdOnes1();
     size_t nextEnd = thisEnd + xdropPadLen + numCells;
 
     size_t a = 2 * (antidiagonalIncludingDummies + 1);
@@ -381,10 +447,10 @@ class GappedXdropAligner {
     scoreEndsAndOrigins[a - 1] = nextEnd - seq1end;
     scoreEndsAndOrigins[a] = nextEnd;
 
-    resizeTinyScoresIfSmaller(nextEnd + (simdBytes-1));
-    simdStore1(&xTinyScores[thisEnd], mNegInf);
-    simdStore1(&yTinyScores[thisEnd], mNegInf);
-    simdStore1(&zTinyScores[thisEnd], mNegInf);
+    resizeTinyScoresIfSmaller(nextEnd + xdropPadLen);
+    std::fill_n(&xTinyScores[thisEnd], xdropPadLen, droppedTinyScore);
+    std::fill_n(&yTinyScores[thisEnd], xdropPadLen, droppedTinyScore);
+    std::fill_n(&zTinyScores[thisEnd], xdropPadLen, droppedTinyScore);
   }
 
   void initTiny(int scoreOffset) {
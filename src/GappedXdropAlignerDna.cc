@@ -14,17 +14,30 @@ const int seqLoadLen = simdBytes;
 
 const int delimiter = 4;
 
-int GappedXdropAligner::alignDna(BigPtr seq1,
-				 const uchar *seq2,
-				 bool isForward,
-				 const ScoreMatrixRow *scorer,
-				 int delOpenCost,
-				 int delGrowCost,
-				 int insOpenCost,
-				 int insGrowCost,
-				 int maxScoreDrop,
-				 int maxMatchScore,
-				 const uchar *toUnmasked) {
+int GappedXdropAligner::MCF_SIMD_NAME(alignDna)(BigPtr seq1,
+						const uchar *seq2,
+						bool isForward,
+						const ScoreMatrixRow *scorer,
+						int delOpenCost,
+						int delGrowCost,
+						int insOpenCost,
+						int insGrowCost,
+						int maxScoreDrop,
+						int maxMatchScore,
+						const uchar *toUnmasked) {
+#if MCF_SIMD_DISPATCH
+  if (simdTier() > 1) {
+    return alignDnaAvx512(seq1, seq2, isForward, scorer,
+			  delOpenCost, delGrowCost, insOpenCost, insGrowCost,
+			  maxScoreDrop, maxMatchScore, toUnmasked);
+  }
+  if (simdTier() > 0) {
+    return alignDnaAvx2(seq1, seq2, isForward, scorer,
+			delOpenCost, delGrowCost, insOpenCost, insGrowCost,
+			maxScoreDrop, maxMatchScore, toUnmasked);
+  }
+#endif
+
   int badScoreDrop = maxScoreDrop + 1;
 
   delGrowCost = std::min(delGrowCost, badScoreDrop);
@@ -44,6 +57,16 @@ int GappedXdropAligner::alignDna(BigPtr seq1,
   const SimdUint1 scorer4x4 =
     simdSet1(
 #ifdef __AVX2__
+#ifdef __AVX512BW__
+		 scorer[3][3], scorer[3][2], scorer[3][1], scorer[3][0],
+		 scorer[2][3], scorer[2][2], scorer[2][1], scorer[2][0],
+		 scorer[1][3], scorer[1][2], scorer[1][1], scorer[1][0],
+		 scorer[0][3], scorer[0][2], scorer[0][1], scorer[0][0],
+		 scorer[3][3], scorer[3][2], scorer[3][1], scorer[3][0],
+		 scorer[2][3], scorer[2][2], scorer[2][1], scorer[2][0],
+		 scorer[1][3], scorer[1][2], scorer[1][1], scorer[1][0],
+		 scorer[0][3], scorer[0][2], scorer[0][1], scorer[0][0],
+#endif
 		 scorer[3][3], scorer[3][2], scorer[3][1], scorer[3][0],
 		 scorer[2][3], scorer[2][2], scorer[2][1], scorer[2][0],
 		 scorer[1][3], scorer[1][2], scorer[1][1], scorer[1][0],
@@ -127,6 +150,40 @@ int GappedXdropAligner::alignDna(BigPtr seq1,
       for (int i = 0; i < numCells; i += simdBytes) {
 	SimdUint1 s = simdSet1(
 #ifdef __AVX2__
+#ifdef __AVX512BW__
+			     scorer[s1[63]][s2[63]],
+			     scorer[s1[62]][s2[62]],
+			     scorer[s1[61]][s2[61]],
+			     scorer[s1[60]][s2[60]],
+			     scorer[s1[59]][s2[59]],
+			     scorer[s1[58]][s2[58]],
+			     scorer[s1[57]][s2[57]],
+			     scorer[s1[56]][s2[56]],
+			     scorer[s1[55]][s2[55]],
+			     scorer[s1[54]][s2[54]],
+			     scorer[s1[53]][s2[53]],
+			     scorer[s1[52]][s2[52]],
+			     scorer[s1[51]][s2[51]],
+			     scorer[s1[50]][s2[50]],
+			     scorer[s1[49]][s2[49]],
+			     scorer[s1[48]][s2[48]],
+			     scorer[s1[47]][s2[47]],
+			     scorer[s1[46]][s2[46]],
+			     scorer[s1[45]][s2[45]],
+			     scorer[s1[44]][s2[44]],
+			     scorer[s1[43]][s2[43]],
+			     scorer[s1[42]][s2[42]],
+			     scorer[s1[41]][s2[41]],
+			     scorer[s1[40]][s2[40]],
+			     scorer[s1[39]][s2[39]],
+			     scorer[s1[38]][s2[38]],
+			     scorer[s1[37]][s2[37]],
+			     scorer[s1[36]][s2[36]],
+			     scorer[s1[35]][s2[35]],
+			     scorer[s1[34]][s2[34]],
+			     scorer[s1[33]][s2[33]],
+			     scorer[s1[32]][s2[32]],
+#endif
 			     scorer[s1[31]][s2[31]],
 			     scorer[s1[30]][s2[30]],
 			     scorer[s1[29]][s2[29]],
@@ -227,6 +284,8 @@ int GappedXdropAligner::alignDna(BigPtr seq1,
   return bestScore;
 }
 
+#if !defined MCF_SIMD_TIER
+
 bool GappedXdropAligner::getNextChunkDna(size_t &end1,
 					 size_t &end2,
 					 size_t &length,
@@ -274,6 +333,8 @@ bool GappedXdropAligner::getNextChunkDna(size_t &end1,
   }
 }
 
+#endif
+
 }
 
 #endif
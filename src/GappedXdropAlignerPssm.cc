@@ -5,18 +5,35 @@
 
 namespace cbrc {
 
-int GappedXdropAligner::alignPssm(BigPtr seq,
-                                  const ScoreMatrixRow *pssm,
-                                  bool isForward,
-				  int globality,
-				  int delExistenceCost,
-				  int delExtensionCost,
-				  int insExistenceCost,
-				  int insExtensionCost,
-                                  int gapUnalignedCost,
-				  bool isAffine,
-                                  int maxScoreDrop,
-                                  int maxMatchScore) {
+int GappedXdropAligner::MCF_SIMD_NAME(alignPssm)(BigPtr seq,
+						 const ScoreMatrixRow *pssm,
+						 bool isForward,
+						 int globality,
+						 int delExistenceCost,
+						 int delExtensionCost,
+						 int insExistenceCost,
+						 int insExtensionCost,
+						 int gapUnalignedCost,
+						 bool isAffine,
+						 int maxScoreDrop,
+						 int maxMatchScore) {
+#if MCF_SIMD_DISPATCH
+  if (simdTier() > 1) {
+    return alignPssmAvx512(seq, pssm, isForward, globality,
+			   delExistenceCost, delExtensionCost,
+			   insExistenceCost, insExtensionCost,
+			   gapUnalignedCost, isAffine, maxScoreDrop,
+			   maxMatchScore);
+  }
+  if (simdTier() > 0) {
+    return alignPssmAvx2(seq, pssm, isForward, globality,
+			 delExistenceCost, delExtensionCost,
+			 insExistenceCost, insExtensionCost,
+			 gapUnalignedCost, isAffine, maxScoreDrop,
+			 maxMatchScore);
+  }
+#endif
+
   const int *vectorOfMatchScores = *pssm;
   const SimdInt mNegInf = simdFill(-INF);
   const SimdInt mDelOpenCost = simdFill(delExistenceCost);
@@ -93,6 +110,16 @@ int GappedXdropAligner::alignPssm(BigPtr seq,
 	SimdInt s = simdSet(
 #if defined __SSE4_1__ || defined __ARM_NEON
 #ifdef __AVX2__
+#ifdef __AVX512BW__
+			    s2[-15][s1[15]],
+			    s2[-14][s1[14]],
+			    s2[-13][s1[13]],
+			    s2[-12][s1[12]],
+			    s2[-11][s1[11]],
+			    s2[-10][s1[10]],
+			    s2[-9][s1[9]],
+			    s2[-8][s1[8]],
+#endif
 			    s2[-7][s1[7]],
 			    s2[-6][s1[6]],
 			    s2[-5][s1[5]],
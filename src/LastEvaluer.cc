@@ -9,10 +9,16 @@
 
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <random>
 
+#ifdef HAS_CXX_THREADS
+#include <thread>
+#endif
+
 #define COUNTOF(a) (sizeof (a) / sizeof *(a))
 
 namespace cbrc {
@@ -117,6 +123,127 @@ static void makeTxFreqs(double *txFreqs, const double *ntFreqs,
 	txFreqs[*codonTable++] += ntFreqs[i] * ntFreqs[j] * ntFreqs[k];
 }
 
+// E-value parameters from ALP simulations can be kept in a cache
+// file.  Each line has a key, which is all the simulation's inputs,
+// then a tab, then the parameters.
+
+static void addToKey(std::ostream &key, const double *values, size_t n) {
+  for (size_t i = 0; i < n; ++i) key << ' ' << values[i];
+}
+
+static void addToKey(std::ostream &key, const long *values, size_t n) {
+  for (size_t i = 0; i < n; ++i) key << ' ' << values[i];
+}
+
+static void addToKey(std::ostream &key, const long *const *matrix,
+		     size_t rows, size_t cols) {
+  for (size_t i = 0; i < rows; ++i) addToKey(key, matrix[i], cols);
+}
+
+static void startKey(std::ostream &key, const char *kind, int delOpen,
+		     int delEpen, int insOpen, int insEpen, int frameshiftCost,
+		     double lambdaTolerance, double kTolerance, long randomSeed) {
+  key.precision(17);
+  key << kind << ' ' << delOpen << ' ' << delEpen << ' ' << insOpen << ' '
+      << insEpen << ' ' << frameshiftCost << ' ' << lambdaTolerance << ' '
+      << kTolerance << ' ' << randomSeed;
+}
+
+static bool readEvalueCache(const std::string &fileName,
+			    const std::string &key,
+			    Sls::AlignmentEvaluerParameters &p) {
+  if (fileName.empty()) return false;
+  std::ifstream f(fileName.c_str());
+  std::string line;
+  while (getline(f, line)) {
+    size_t tab = line.find('\t');
+    if (tab != key.size() || line.compare(0, tab, key) != 0) continue;
+    std::istringstream iss(line.substr(tab + 1));
+    iss >> p.d_lambda >> p.d_k >> p.d_a1 >> p.d_b1 >> p.d_a2 >> p.d_b2
+	>> p.d_alpha1 >> p.d_beta1 >> p.d_alpha2 >> p.d_beta2
+	>> p.d_sigma >> p.d_tau;
+    if (iss) return true;
+  }
+  return false;
+}
+
+static void writeEvalueCache(const std::string &fileName,
+			     const std::string &key,
+			     const Sls::AlignmentEvaluerParameters &p) {
+  if (fileName.empty()) return;
+  std::ostringstream line;
+  line.precision(17);
+  line << key << '\t' << p.d_lambda << ' ' << p.d_k << ' '
+       << p.d_a1 << ' ' << p.d_b1 << ' ' << p.d_a2 << ' ' << p.d_b2 << ' '
+       << p.d_alpha1 << ' ' << p.d_beta1 << ' '
+       << p.d_alpha2 << ' ' << p.d_beta2 << ' '
+       << p.d_sigma << ' ' << p.d_tau << '\n';
+  // write the whole line at once, in case of concurrent lastal runs
+  std::ofstream f(fileName.c_str(), std::ios::app);
+  f << line.str() << std::flush;
+  if (!f) std::cerr << "lastal: can't write file: " << fileName << '\n';
+}
+
+static Sls::AlignmentEvaluerParameters
+parametersOf(const Sls::AlignmentEvaluer &evaluer) {
+  const Sls::ALP_set_of_parameters &p = evaluer.parameters();
+  Sls::AlignmentEvaluerParameters q = {p.lambda, p.K,
+				       p.a_J, p.b_J,
+				       p.a_I, p.b_I,  // !!! flip (I, J)
+				       p.alpha_J, p.beta_J,
+				       p.alpha_I, p.beta_I,
+				       p.sigma, p.tau};
+  return q;
+}
+
+// One ALP simulation for gapped alignment, at one temperature
+struct GappedTry {
+  Sls::AlignmentEvaluer evaluer;
+  double temperature;
+  bool isOk;
+  long errorCode;
+  std::string errorText;
+};
+
+static void runGappedTries(GappedTry *tries, size_t numOfTries,
+			   size_t alphabetSize, const long *const *matrix,
+			   const double *letterFreqs1,
+			   const double *letterFreqs2,
+			   int delOpen, int delEpen, int insOpen, int insEpen,
+			   double lambdaTolerance, double kTolerance,
+			   double maxMegabytes, long randomSeed,
+			   double maxSeconds) {
+  if (numOfTries > 1) {
+#ifdef HAS_CXX_THREADS
+    std::thread t(runGappedTries, tries + 1, numOfTries - 1,
+		  alphabetSize, matrix, letterFreqs1, letterFreqs2,
+		  delOpen, delEpen, insOpen, insEpen,
+		  lambdaTolerance, kTolerance, maxMegabytes, randomSeed,
+		  maxSeconds);
+    runGappedTries(tries, 1, alphabetSize, matrix,
+		   letterFreqs1, letterFreqs2, delOpen, delEpen,
+		   insOpen, insEpen, lambdaTolerance, kTolerance,
+		   maxMegabytes, randomSeed, maxSeconds);
+    t.join();
+#endif
+    return;
+  }
+  GappedTry &x = *tries;
+  try {
+    x.evaluer.set_gapped_computation_parameters_simplified(maxSeconds);
+    x.evaluer.initGapped(alphabetSize, matrix,
+			 letterFreqs1, letterFreqs2,
+			 delOpen, delEpen, insOpen, insEpen,
+			 true, lambdaTolerance, kTolerance,
+			 0, maxMegabytes, randomSeed, x.temperature);
+    x.isOk = true;
+  } catch (const Sls::error& e) {
+    x.isOk = false;
+    x.errorCode = e.error_code;
+    x.errorText = e.st;
+  }
+}
+
 void LastEvaluer::init(const char *matrixName,
 		       int matchScore,
 		       int mismatchCost,
@@ -132,7 +259,9 @@ void LastEvaluer::init(const char *matrixName,
 		       int frameshiftCost,
 		       const GeneticCode &geneticCode,
 		       const char *geneticCodeName,
-		       int verbosity) {
+		       int verbosity,
+		       unsigned numOfThreads,
+		       const std::string &cacheFileName) {
   const double lambdaTolerance = 0.01;
   const double kTolerance = 0.05;
   const double maxMegabytes = 500;
@@ -169,6 +298,19 @@ void LastEvaluer::init(const char *matrixName,
     std::vector<double> aaFreqs(matrixSize);
     copy(letterFreqs1, letterFreqs1 + alphabetSize, aaFreqs.begin());
 
+    std::ostringstream key;
+    if (isGapped) {
+      startKey(key, "frameshift", delOpen, delEpen, insOpen, insEpen,
+	       frameshiftCost, lambdaTolerance, kTolerance, randomSeed);
+      addToKey(key, &matrix[0], matrixSize, matrixSize);
+      addToKey(key, codonTable, 64);
+      addToKey(key, &ntFreqs[0], 4);
+      addToKey(key, &aaFreqs[0], matrixSize);
+      Sls::AlignmentEvaluerParameters q;
+      if (readEvalueCache(cacheFileName, key.str(), q))
+	return evaluer.initParameters(q);
+    }
+
     if (isGapped && frameshiftCost > 0) {  // with frameshifts:
       Sls::FrameshiftAlignmentEvaluer frameshiftEvaluer;
       frameshiftEvaluer.initFrameshift(4, matrixSize, codonTable,
@@ -185,6 +327,7 @@ void LastEvaluer::init(const char *matrixName,
 					   p.alpha_J, p.beta_J,
 					   p.sigma, p.tau};
       evaluer.initParameters(q);
+      writeEvalueCache(cacheFileName, key.str(), q);
     } else {  // without frameshifts:
       std::vector<double> txFreqs(matrixSize);
       makeTxFreqs(&txFreqs[0], &ntFreqs[0], codonTable);
@@ -205,6 +348,7 @@ void LastEvaluer::init(const char *matrixName,
 					   p.alpha_I, p.beta_I,
 					   p.sigma * 3, p.tau * 3};
       evaluer.initParameters(q);
+      if (isGapped) writeEvalueCache(cacheFileName, key.str(), q);
     }
   } else {  // ordinary alignment:
     if (isGapped && insOpen == delOpen && insEpen == delEpen) {
@@ -238,24 +382,47 @@ void LastEvaluer::init(const char *matrixName,
     copyMatrix(alphabetSize, scoreMatrix, &matrix[0]);
 
     if (isGapped) {
-      evaluer.set_gapped_computation_parameters_simplified(maxSeconds);
-      for (int i = 0; ; ++i) {
-	double t = Sls::default_importance_sampling_temperature + 0.01 * i;
-	if (verbosity > 0) std::cerr << "try temperature=" << t << " ";
-	try {
-	  evaluer.initGapped(alphabetSize, &matrix[0],
-			     letterFreqs2, letterFreqs1,
-			     delOpen, delEpen, insOpen, insEpen,
-			     true, lambdaTolerance, kTolerance,
-			     0, maxMegabytes, randomSeed, t);
-	  if (verbosity > 0) std::cerr << "OK\n";
-	  break;
-	} catch (const Sls::error& e) {
-	  if (verbosity > 0) std::cerr << "NG\n";
+      std::ostringstream key;
+      startKey(key, "gapped", delOpen, delEpen, insOpen, insEpen,
+	       -1, lambdaTolerance, kTolerance, randomSeed);
+      addToKey(key, &matrix[0], alphabetSize, alphabetSize);
+      addToKey(key, letterFreqs2, alphabetSize);
+      addToKey(key, letterFreqs1, alphabetSize);
+      Sls::AlignmentEvaluerParameters q;
+      if (readEvalueCache(cacheFileName, key.str(), q))
+	return evaluer.initParameters(q);
+
+      // If the first temperature fails, try the next ones in
+      // parallel.  Each try is independent, so we get the same result
+      // as trying them one by one.
+      const int maxTries = 21;
+      std::vector<GappedTry> tries(maxTries);
+      for (int i = 0; i < maxTries; ++i) {
+	tries[i].temperature =
+	  Sls::default_importance_sampling_temperature + 0.01 * i;
+      }
+      for (int i = 0; ; ) {
+	int n = (i > 0) ? std::min<int>(numOfThreads, maxTries - i) : 1;
+	runGappedTries(&tries[i], n, alphabetSize, &matrix[0],
+		       letterFreqs2, letterFreqs1,
+		       delOpen, delEpen, insOpen, insEpen,
+		       lambdaTolerance, kTolerance, maxMegabytes, randomSeed,
+		       maxSeconds);
+	for (int j = i + n; i < j; ++i) {
+	  const GappedTry &x = tries[i];
+	  if (verbosity > 0) {
+	    std::cerr << "try temperature=" << x.temperature << " ";
+	    std::cerr << (x.isOk ? "OK\n" : "NG\n");
+	  }
+	  if (x.isOk) {
+	    evaluer = x.evaluer;
+	    writeEvalueCache(cacheFileName, key.str(), parametersOf(evaluer));
+	    return;
+	  }
 	  if (verbosity > 1) {
-	    std::cerr << "ALP: " << e.error_code << ": " << e.st;
+	    std::cerr << "ALP: " << x.errorCode << ": " << x.errorText;
 	  }
-	  if (i == 20) throw;
+	  if (i + 1 == maxTries) throw Sls::error(x.errorText, x.errorCode);
 	}
       }
     } else {
@@ -22,6 +22,8 @@
 
 #include "alp/sls_alignment_evaluer.hpp"
 
+#include <string>
+
 namespace cbrc {
 
 using namespace mcf;
@@ -39,6 +41,10 @@ public:
   // As a special case, frameshiftCost==0 means no frameshifts.
   // For DNA-versus-protein alignment, letterFreqs2 should either be
   // NULL or point to 64 codon frequencies (aaa, aac, etc).
+  // If the parameters must be calculated by simulation, they are
+  // looked up in, or else added to, cacheFileName (if not empty).
+  // Simulations at different temperatures may run in numOfThreads
+  // threads.
   void init(const char *matrixName,
 	    int matchScore,
 	    int mismatchCost,
@@ -54,7 +60,9 @@ public:
 	    int frameshiftCost,
 	    const GeneticCode &geneticCode,
 	    const char *geneticCodeName,
-	    int verbosity);
+	    int verbosity,
+	    unsigned numOfThreads = 1,
+	    const std::string &cacheFileName = "");
 
   // initFullScores sets up for sum-of-paths local alignment scores.
   // isFrameshift=true implements section 2.6 of "Improved
@@ -55,6 +55,7 @@ static char parseOutputFormat( const char* text ){
   if( s == "maf" || s == "1" ) return 'm';
   if( s == "blasttab" )        return 'b';
   if( s == "blasttab+" )       return 'B';
+  if( s == "binary" )          return 'r';
   return 0;
 }
 
@@ -111,6 +112,10 @@ LastalArguments::LastalArguments() :
   queryStep(1),
   minimizerWindow(0),  // depends on the reference's minimizer window
   batchSize(0),  // depends on voluming
+  isPreloadVolumes(false),
+  isKeepAllVolumes(false),
+  loadMethod(0),
+  isInterleaveNodes(false),
   numOfThreads(1),
   maxRepeatDistance(1000),  // sufficiently conservative?
   temperature(-1),  // depends on the score matrix
@@ -132,7 +137,8 @@ Cosmetic options:\n\
  -V, --version  show version information, and exit\n\
  -v             be verbose: write messages about what lastal is doing\n\
  -2             paired query sequences\n\
- -f             output format: TAB, MAF, BlastTab, BlastTab+ (default: MAF)";
+ -f             output format: TAB, MAF, BlastTab, BlastTab+, binary\n\
+                (default: MAF)";
 
   std::string help = usage + "\n\
 \n\
@@ -141,6 +147,7 @@ E-value options (default settings):\n\
     + stringify(default_D) + ")\n\
  -H  expected total number of random alignments for all the sequences\n\
  -E  max EG2: expected number of random alignments per square giga\n\
+ --evalue-cache=FILE  keep E-value parameters from simulations in FILE\n\
 \n\
 Score options (default settings):\n\
  -r  match score   (2 if -M, else 1)\n\
@@ -181,6 +188,12 @@ Miscellaneous options (default settings):\n\
  -S  use score matrix: 0=as-is, 1=on query forward strands ("
     + stringify(isQueryStrandMatrix) + ")\n\
  -i  query batch size (64M if multi-volume, else off)\n\
+ --preload    read the next database volume while aligning to this one\n\
+ --keep-volumes  keep all database volumes in memory, and align to them\n\
+                 in parallel\n\
+ --load=METHOD  how to load the database: map, copy, huge, shared\n\
+                (default: map)\n\
+ --interleave   spread the database over all NUMA nodes\n\
  -M  find minimum-difference alignments (faster but cruder)\n\
  -T  type of alignment: 0=local, 1=overlap (default: "
     + stringify(globality) + ")\n\
@@ -231,6 +244,11 @@ Split options:\n\
     { "reverse", no_argument,          0, 'R' - 'A' },
     { "gumbel-len", required_argument, 0, 'L' - 'A' },
     { "gumbel-num", required_argument, 0, 'N' - 'A' },
+    { "evalue-cache", required_argument, 0, 'E' - 'A' },
+    { "preload", no_argument,       0, 'P' - 'A' },
+    { "keep-volumes", no_argument,  0, 'K' - 'A' },
+    { "load",    required_argument, 0, 'O' - 'A' },
+    { "interleave", no_argument,    0, 'I' - 'A' },
     { "split",   no_argument,       0, 128 + 0 },
     { "splice",  no_argument,       0, 128 + 1 },
     { "split-f", required_argument, 0, 128 + 'f' },
@@ -441,6 +459,25 @@ Split options:\n\
       unstringify(gumbelSimAlignmentCount, optarg);
       if (gumbelSimAlignmentCount <= 0) badopt(lOpts[lOptsIndex].name, optarg);
       break;
+    case 'E' - 'A':
+      evalueCacheFile = optarg;
+      break;
+    case 'P' - 'A':
+      isPreloadVolumes = true;
+      break;
+    case 'K' - 'A':
+      isKeepAllVolumes = true;
+      break;
+    case 'O' - 'A':
+      if      (strcmp(optarg, "map" ) == 0) loadMethod = 0;
+      else if (strcmp(optarg, "copy") == 0) loadMethod = 1;
+      else if (strcmp(optarg, "huge") == 0) loadMethod = 2;
+      else if (strcmp(optarg, "shared") == 0) loadMethod = 3;
+      else badopt(lOpts[lOptsIndex].name, optarg);
+      break;
+    case 'I' - 'A':
+      isInterleaveNodes = true;
+      break;
 
     case 128 + 1:
       splitOpts.isSplicedAlignment = true;
@@ -691,6 +728,9 @@ To proceed without E-values, set a score threshold with option -e.");
     maxDropGapless = std::min( maxDropGapless, maxDropGapped );
   }
 
+  if (outputFormat == 'r' && isTranslated())
+    ERR("can't do binary output with DNA-protein alignment");
+
   if (isSplit) {
     if (outputFormat != 'm')
       ERR("can't do split alignment with non-MAF output");
@@ -125,6 +125,10 @@ struct LastalArguments{
   size_t queryStep;
   size_t minimizerWindow;
   size_t batchSize;  // approx size of query sequences to scan in 1 batch
+  bool isPreloadVolumes;  // read the next volume while aligning to this one
+  bool isKeepAllVolumes;  // keep all volumes in memory at once
+  int loadMethod;  // load database files: 0=map, 1=copy, 2=huge, 3=shared
+  bool isInterleaveNodes;  // spread the database over NUMA nodes
   unsigned numOfThreads;
   size_t maxRepeatDistance;  // suppress repeats <= this distance apart
   double temperature;  // probability = exp( score / temperature ) / Z
@@ -134,6 +138,7 @@ struct LastalArguments{
 
   int gumbelSimSequenceLength;
   int gumbelSimAlignmentCount;
+  std::string evalueCacheFile;
 
   bool isSplit;
   LastSplitOptions splitOpts;
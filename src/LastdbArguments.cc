@@ -44,7 +44,9 @@ LastdbArguments::LastdbArguments() :
   isDump(false),
   verbosity(0),
   inputFormat(sequenceFormat::fasta),
-  bitsPerBase(8){}
+  bitsPerBase(8),
+  volumesAtOnce(1),
+  isAppend(false){}
 
 void LastdbArguments::fromArgs( int argc, char** argv, bool isOptionsOnly ){
   programName = argv[0];
@@ -89,6 +91,9 @@ Advanced Options (default settings):\n\
  --bits=N  use this many bits per base for DNA sequence (default: "
     + stringify(bitsPerBase) + ")\n\
  --circular  these sequences are circular\n\
+ --append  add the sequences to an existing database, as new volumes\n\
+ --pipeline=N  read the next volume while making at most N-1 others ("
+    + stringify(volumesAtOnce) + ")\n\
  -v  be verbose: write messages about what lastdb is doing\n\
  -V, --version  show version information, and exit\n\
 ";
@@ -100,6 +105,8 @@ Advanced Options (default settings):\n\
     { "version", no_argument, 0, 'V' },
     { "bits",    required_argument, 0, 128 },
     { "circular", no_argument, 0, 'C' - 'A' },
+    { "pipeline", required_argument, 0, 129 },
+    { "append",  no_argument, 0, 130 },
     { 0, 0, 0, 0 }
   };
 
@@ -200,6 +207,13 @@ Advanced Options (default settings):\n\
       if (bitsPerBase != 4 &&
 	  bitsPerBase != 8) badopt(lOpts[optionIndex].name, optarg);
       break;
+    case 129:
+      unstringify(volumesAtOnce, optarg);
+      if (volumesAtOnce < 1) badopt(lOpts[optionIndex].name, optarg);
+      break;
+    case 130:
+      isAppend = true;
+      break;
     case '?':
       ERR( "bad option" );
     }
@@ -209,6 +223,10 @@ Advanced Options (default settings):\n\
     ERR("can't use --bits=4 with non-default alphabet");
   }
 
+  if (isAppend && (isCountsOnly || isDump)) {
+    ERR("can't use --append with -x or -D");
+  }
+
   if (tantanSetting > 0 && maxRepeatUnit == 0) {
     ERR("can't find repeats with maximum unit length 0");
   }
@@ -64,6 +64,8 @@ struct LastdbArguments{
   int verbosity;
   sequenceFormat::Enum inputFormat;
   int bitsPerBase;
+  unsigned volumesAtOnce;
+  bool isAppend;
 
   // positional arguments:
   const char* programName;
@@ -37,6 +37,38 @@ void MultiSequence::reinitForAppending(){
   }
 }
 
+void MultiSequence::reinitFromSequences(const MultiSequence &m,
+					size_t seqNum) {
+  size_t s = m.padBeg(seqNum);
+  size_t n = m.nameEnds.v[seqNum];
+  padSize = m.padSize;
+
+  seq.v.assign(m.seq.v.begin() + s, m.seq.v.end());
+  ends.v.assign(1, padSize);
+  for (size_t i = seqNum + 1; i < m.ends.v.size(); ++i) {
+    ends.v.push_back(m.ends.v[i] - s);
+  }
+
+  names.v.assign(m.names.v.begin() + n, m.names.v.end());
+  nameEnds.v.assign(1, 0);
+  for (size_t i = seqNum + 1; i < m.nameEnds.v.size(); ++i) {
+    nameEnds.v.push_back(m.nameEnds.v[i] - n);
+  }
+
+  qualityScoresPerLetter = m.qualityScoresPerLetter;
+  qualityScores.v.assign(m.qualityScores.v.begin() + s * qualsPerLetter(),
+			 m.qualityScores.v.end());
+
+  pssm.clear();
+  if (!m.pssm.empty()) {
+    pssm.assign(m.pssm.begin() + s * scoreMatrixRowSize, m.pssm.end());
+  }
+  pssmColumnLetters = m.pssmColumnLetters;
+
+  isReadingFastq = m.isReadingFastq;
+  isAppendingStopSymbol = m.isAppendingStopSymbol;
+}
+
 void MultiSequence::fromFiles(const std::string &baseName, size_t seqCount,
 			      size_t qualitiesPerLetter, bool is4bit,
 			      bool isSmallCoords) {
@@ -37,6 +37,10 @@ class MultiSequence{
     ends.v.push_back(seq.v.size());
   }
 
+  // re-initialize, with copies of m's sequences from seqNum onwards
+  // (the last of which may be unfinished), ready for appending
+  void reinitFromSequences(const MultiSequence &m, size_t seqNum);
+
   // read seqCount finished sequences, and their names, from binary files
   void fromFiles(const std::string &baseName, size_t seqCount,
 		 size_t qualitiesPerLetter, bool is4bit, bool isSmallCoords);
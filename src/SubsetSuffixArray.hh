@@ -35,6 +35,7 @@
 #include "mcf_packed_array.hh"
 #include "VectorOrMmap.hh"
 
+#include <algorithm>  // max
 #include <climits>
 
 namespace cbrc {
@@ -64,6 +65,15 @@ inline size_t getItem(ConstPackedArray a, size_t i) {
     |    (size_t)c[i*5 + 4] << 32;
 }
 
+// Ask the CPU to start fetching the i-th item into the cache
+inline void prefetchItem(ConstPackedArray a, size_t i) {
+#ifdef __GNUC__
+  unsigned long long bits = (a.bitsPerItem & 128) == 0 ? a.bitsPerItem
+    : (a.bitsPerItem == 128 + 32) ? 32 : 40;  // old lastdb databases
+  __builtin_prefetch((const char *)a.items + i * bits / CHAR_BIT);
+#endif
+}
+
 inline size_t maxBucketDepth(const CyclicSubsetSeed &seed, size_t startDepth,
 			     size_t maxBuckets, unsigned wordLength) {
   unsigned long long numOfBuckets = (startDepth > 0);  // delimiter if depth>0
@@ -129,6 +139,22 @@ public:
     return getItem(sufArray, i);
   }
 
+  // Get items beg to end-1 of the suffix array, faster than calling
+  // getPosition for each one
+  void getPositions(size_t *positions, size_t beg, size_t end) const {
+    if ((sufArray.bitsPerItem & 128) == 0) {
+      unpackBits(sufArray.bitsPerItem, sufArray.items, positions, beg, end);
+    } else {
+      for (size_t i = beg; i < end; ++i) *positions++ = getItem(sufArray, i);
+    }
+  }
+
+  // Minimum distance between items of the suffix array, such that
+  // different threads can set them at the same time
+  size_t positionsBetweenThreads() const {
+    return numOfItemsBetweenWrites(sufArray.bitsPerItem);
+  }
+
   // Set the i-th item of the suffix array to x
   void setPosition(size_t i, size_t x) {
     setBits(sufArray.bitsPerItem, (size_t *)&suffixArray.v[0], i, x);
@@ -171,6 +197,15 @@ public:
 	     const uchar *queryPtr, BigSeq text, unsigned seedNum,
 	     size_t maxHits, size_t minDepth, size_t maxDepth) const;
 
+  // Do match for n query positions, with seed numbers seedNums.  This
+  // advances all the positions in lock-step, prefetching the next
+  // bucket and suffix array entries, so that the memory reads for
+  // different positions overlap.  Returns the ranges via begs and ends.
+  void matchMany(size_t *begs, size_t *ends,
+		 const uchar *const *queryPtrs, const unsigned *seedNums,
+		 size_t n, BigSeq text,
+		 size_t maxHits, size_t minDepth, size_t maxDepth) const;
+
   // Count matches of all sizes (up to maxDepth), starting at the
   // given position in the query.
   void countMatches( std::vector<unsigned long long>& counts,
@@ -197,6 +232,32 @@ private:
 
   enum ChildDirection { FORWARD, REVERSE, UNKNOWN };
 
+  // The state of a match, after matching using buckets
+  struct MatchState {
+    size_t bucketIdx;
+    size_t depth;
+    const uchar *subsetMap;
+  };
+
+  // Match a query position using buckets, up to maxDepth.  (This only
+  // looks at the query, not at the index.)
+  void matchBuckets(MatchState &state, const uchar *queryPtr,
+		    unsigned seedNum, size_t maxDepth) const;
+
+  // Given the bucket range [beg, end), finish the match
+  void matchRest(size_t &beg, size_t &end, const MatchState &state,
+		 const uchar *queryPtr, BigSeq text, unsigned seedNum,
+		 size_t maxHits, size_t minDepth, size_t maxDepth) const;
+
+  size_t bucketBeg(const MatchState &state) const {
+    return getItem(bckArray, state.bucketIdx);
+  }
+
+  size_t bucketEnd(const MatchState &state, unsigned seedNum) const {
+    size_t step = bucketStepEnds[seedNum][state.depth];
+    return getItem(bckArray, state.bucketIdx + step);
+  }
+
   // This does the same thing as equalRange, but uses a child table:
   void childRange(size_t &beg, size_t &end, ChildDirection &childDirection,
 		  BigPtr textBase, const uchar *subsetMap, uchar subset) const;
@@ -250,7 +311,23 @@ private:
 		  size_t *intCache, uchar *seqCache, const uchar *text,
 		  unsigned wordLength, unsigned seedNum,
 		  size_t maxUnsortedRange,
-		  size_t numOfThreads, size_t endOfRanges);
+		  size_t numOfThreads, size_t endOfRanges, size_t shift);
+
+  // Minimum distance between items of the suffix array and child
+  // table, such that different threads can sort them at the same time
+  size_t itemsBetweenSortThreads() const {
+    size_t n = numOfItemsBetweenWrites(sufArray.bitsPerItem);
+    if (childTable.v.empty()) return n;
+    return std::max(n, size_t(numOfItemsBetweenWrites(chiArray.bitsPerItem)));
+  }
+
+  // Copy child table items [from, from+count) to [to, to+count)
+  void copyChildItems(size_t from, size_t to, size_t count);
+
+  // While sorting, each thread's part of the suffix array is shifted
+  // up by this much (see sortRanges).  It's subtracted from child
+  // table items, which are suffix array indices.
+  static thread_local size_t childShift;
 
   size_t getChild(size_t i) const {
     if ((chiArray.bitsPerItem & 128) == 0) return chiArray[i];
@@ -277,7 +354,8 @@ private:
   }
 
   void setChild(size_t index, size_t value) {
-    setBits(chiArray.bitsPerItem, (size_t *)&childTable.v[0], index, value);
+    setBits(chiArray.bitsPerItem, (size_t *)&childTable.v[0], index,
+	    value - childShift);
   }
 
   void setKiddy(size_t index, size_t value) {
@@ -317,20 +317,13 @@ static size_t equalRange3(ConstPackedArray sufArray, size_t &beg, size_t &end,
   return qMid - queryBeg;
 }
 
-// use past results to speed up long matches?
-// could & probably should return the match depth
-void SubsetSuffixArray::match(size_t &beg, size_t &end,
-			      const uchar *queryPtr, BigSeq text,
-			      unsigned seedNum, size_t maxHits,
-			      size_t minDepth, size_t maxDepth) const {
-  // the next line is unnecessary, but makes it faster in some cases:
-  if( maxHits == 0 && minDepth < maxDepth ) minDepth = maxDepth;
-
+void SubsetSuffixArray::matchBuckets(MatchState &state,
+				     const uchar *queryPtr, unsigned seedNum,
+				     size_t maxDepth) const {
   size_t depth = 0;
   const CyclicSubsetSeed &seed = seeds[seedNum];
   const uchar* subsetMap = seed.firstMap();
 
-  // match using buckets:
   size_t bucketDepth = maxBucketPrefix(seedNum);
   size_t startDepth = std::min( bucketDepth, maxDepth );
   size_t bucketIdx = bucketEnds[seedNum];
@@ -344,8 +337,87 @@ void SubsetSuffixArray::match(size_t &beg, size_t &end,
     subsetMap = seed.nextMap( subsetMap );
   }
 
-  beg = getItem(bckArray, bucketIdx);
-  end = getItem(bckArray, bucketIdx + myBucketSteps[depth]);
+  state.bucketIdx = bucketIdx;
+  state.depth = depth;
+  state.subsetMap = subsetMap;
+}
+
+// use past results to speed up long matches?
+// could & probably should return the match depth
+void SubsetSuffixArray::match(size_t &beg, size_t &end,
+			      const uchar *queryPtr, BigSeq text,
+			      unsigned seedNum, size_t maxHits,
+			      size_t minDepth, size_t maxDepth) const {
+  // the next line is unnecessary, but makes it faster in some cases:
+  if( maxHits == 0 && minDepth < maxDepth ) minDepth = maxDepth;
+
+  MatchState state;
+  matchBuckets(state, queryPtr, seedNum, maxDepth);
+  beg = bucketBeg(state);
+  end = bucketEnd(state, seedNum);
+  matchRest(beg, end, state, queryPtr, text, seedNum,
+	    maxHits, minDepth, maxDepth);
+}
+
+void SubsetSuffixArray::matchMany(size_t *begs, size_t *ends,
+				  const uchar *const *queryPtrs,
+				  const unsigned *seedNums, size_t n,
+				  BigSeq text, size_t maxHits,
+				  size_t minDepth, size_t maxDepth) const {
+  if( maxHits == 0 && minDepth < maxDepth ) minDepth = maxDepth;
+
+  const size_t batchSize = 16;
+  MatchState s[batchSize];
+
+  for (size_t b = 0; b < n; b += batchSize) {
+    size_t m = std::min(n - b, batchSize);
+    size_t *bs = begs + b;
+    size_t *es = ends + b;
+    const uchar *const *qs = queryPtrs + b;
+    const unsigned *ns = seedNums + b;
+
+    for (size_t i = 0; i < m; ++i) {
+      matchBuckets(s[i], qs[i], ns[i], maxDepth);
+      prefetchItem(bckArray, s[i].bucketIdx);
+      prefetchItem(bckArray,
+		   s[i].bucketIdx + bucketStepEnds[ns[i]][s[i].depth]);
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+      bs[i] = bucketBeg(s[i]);
+      es[i] = bucketEnd(s[i], ns[i]);
+      if (bs[i] < es[i]) {
+	prefetchItem(sufArray, bs[i]);
+	prefetchItem(sufArray, es[i] - 1);
+      }
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+      if (es[i] - bs[i] > maxHits && s[i].depth < maxDepth) {
+	prefetch(text, getItem(sufArray, bs[i]) + s[i].depth);
+	prefetch(text, getItem(sufArray, es[i] - 1) + s[i].depth);
+      }
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+      matchRest(bs[i], es[i], s[i], qs[i], text, ns[i],
+		maxHits, minDepth, maxDepth);
+    }
+  }
+}
+
+void SubsetSuffixArray::matchRest(size_t &beg, size_t &end,
+				  const MatchState &state,
+				  const uchar *queryPtr,
+				  BigSeq text, unsigned seedNum,
+				  size_t maxHits, size_t minDepth,
+				  size_t maxDepth) const {
+  size_t depth = state.depth;
+  const CyclicSubsetSeed &seed = seeds[seedNum];
+  const uchar* subsetMap = state.subsetMap;
+  size_t bucketIdx = state.bucketIdx;
+  const size_t *myBucketSteps = bucketStepEnds[seedNum];
+
   assert(beg <= end);  // can fail for corrupted bck file
 
   while( depth > minDepth && end - beg < maxHits ){
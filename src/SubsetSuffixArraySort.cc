@@ -20,6 +20,8 @@ namespace{
   typedef SubsetSuffixArray::Range Range;
 }
 
+thread_local size_t SubsetSuffixArray::childShift;
+
 static void pushRange(std::vector<Range> &v,
 		      size_t beg, size_t end, size_t depth) {
   if (end - beg > 1) {
@@ -345,6 +347,7 @@ void SubsetSuffixArray::radixSortN(std::vector<Range> &rangeStack,
     i = j;
   }
 
+  bucketSizes[CyclicSubsetSeed::DELIMITER] = 0;  // reset it so we can reuse it
   setChildLink(isChildFwd, 0, beg, end, pos, end);
 }
 
@@ -533,15 +536,38 @@ void SubsetSuffixArray::sortOutOfPlace(std::vector<Range> &stack,
   }
 }
 
+void SubsetSuffixArray::copyChildItems(size_t from, size_t to,
+				       size_t count) {
+  if (!chibiTable.v.empty()) {
+    memmove(&chibiTable.v[to], &chibiTable.v[from], count);
+  } else if (!kiddyTable.v.empty()) {
+    memmove(&kiddyTable.v[to], &kiddyTable.v[from], count * 2);
+  } else if (!childTable.v.empty()) {
+    size_t *c = (size_t *)&childTable.v[0];
+    const int bits = chiArray.bitsPerItem;
+    if (to > from) {
+      for (size_t i = count; i-- > 0;) {
+	setBits(bits, c, to + i, getBits(bits, c, from + i));
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+	setBits(bits, c, to + i, getBits(bits, c, from + i));
+      }
+    }
+  }
+}
+
 void SubsetSuffixArray::sortRanges(std::vector<Range> *stacks,
 				   size_t cacheSize,
 				   size_t *intCache, uchar *seqCache,
 				   const uchar *text, unsigned wordLength,
 				   unsigned seedNum, size_t maxUnsortedRange,
-				   size_t numOfThreads, size_t endOfRanges) {
+				   size_t numOfThreads, size_t endOfRanges,
+				   size_t shift) {
   std::vector<Range> &myStack = stacks[0];
   size_t *a = (size_t *)&suffixArray.v[0];
   const int bits = sufArray.bitsPerItem;
+  childShift = shift;
 
   while (!myStack.empty()) {
 #ifdef HAS_CXX_THREADS
@@ -552,7 +578,7 @@ void SubsetSuffixArray::sortRanges(std::vector<Range> *stacks,
       size_t thisThreads = numOfThreadsForOneRange(numOfThreads, thisSize,
 						   totalSize, numOfChunks - 1);
       numOfThreads -= thisThreads;
-      size_t pad = numOfItemsBetweenWrites(bits) * numOfThreads;
+      size_t pad = itemsBetweenSortThreads() * numOfThreads;
 
       do {
 	totalSize -= nextRangeSize(myStack);
@@ -572,6 +598,7 @@ void SubsetSuffixArray::sortRanges(std::vector<Range> *stacks,
       for (size_t i = end; i-- > beg;) {
 	setBits(bits, a, i, getBits(bits, a, i - pad));
       }
+      copyChildItems(beg - pad, beg, end - beg);
 
       size_t intCacheSize = cacheSize * 2 + numOfBuckets;
       std::thread myThread(&SubsetSuffixArray::sortRanges, this,
@@ -579,14 +606,15 @@ void SubsetSuffixArray::sortRanges(std::vector<Range> *stacks,
 			   intCache + numOfThreads * intCacheSize,
 			   seqCache + numOfThreads * cacheSize,
 			   text, wordLength, seedNum,
-			   maxUnsortedRange, thisThreads, end);
+			   maxUnsortedRange, thisThreads, end, shift + pad);
       sortRanges(stacks, cacheSize, intCache, seqCache, text, wordLength,
-		 seedNum, maxUnsortedRange, numOfThreads, beg - pad);
+		 seedNum, maxUnsortedRange, numOfThreads, beg - pad, shift);
       myThread.join();
 
       for (size_t i = beg; i < end; ++i) {
 	setBits(bits, a, i - pad, getBits(bits, a, i));
       }
+      copyChildItems(beg, beg - pad, end - beg);
 
       // unnecessary: aims to make all output bits unchanged by multi-threading
       for (size_t i = end - pad; i < end; ++i) setBits(bits, a, i, 0);
@@ -650,16 +678,27 @@ void SubsetSuffixArray::sortIndex(const uchar *text,
 				  size_t maxUnsortedRange,
 				  int childTableType,
 				  size_t numOfThreads) {
-  if (childTableType) numOfThreads = 1;
   size_t numOfSeeds = seeds.size();
   size_t total = cumulativeCounts[numOfSeeds - 1];
   size_t cacheSize = total / (32 * sizeof(size_t)) / numOfThreads;
   // tie-breaking depends on cacheSize, so it depends on numOfThreads
 
-  if (childTableType == 1) chibiTable.v.assign(total, -1);
-  if (childTableType == 2) kiddyTable.v.assign(total, -1);
   if (childTableType == 3) {
     childTable.v.assign(numOfBytes(chiArray.bitsPerItem, total), 0);
+  }
+
+  // room for shifting the threads' parts of the arrays (see sortRanges)
+  size_t pad = itemsBetweenSortThreads() * (numOfThreads - 1);
+  size_t sufBytes = numOfBytes(sufArray.bitsPerItem, total + pad);
+  if (suffixArray.v.size() < sufBytes) {
+    suffixArray.v.resize(sufBytes);
+    sufArray.items = (const size_t *)suffixArray.begin();
+  }
+
+  if (childTableType == 1) chibiTable.v.assign(total + pad, -1);
+  if (childTableType == 2) kiddyTable.v.assign(total + pad, -1);
+  if (childTableType == 3) {
+    childTable.v.resize(numOfBytes(chiArray.bitsPerItem, total + pad));
     chiArray.items = (const size_t *)childTable.begin();
   }
 
@@ -676,5 +715,12 @@ void SubsetSuffixArray::sortIndex(const uchar *text,
   }
 
   sortRanges(&stacks[0], cacheSize, &intCache[0], &seqCache[0], text,
-	     wordLength, 0, maxUnsortedRange, numOfThreads, beg);
+	     wordLength, 0, maxUnsortedRange, numOfThreads, beg, 0);
+
+  if (childTableType == 1) chibiTable.v.resize(total);
+  if (childTableType == 2) kiddyTable.v.resize(total);
+  if (childTableType == 3) {
+    for (size_t i = total; i < total + pad; ++i) setChild(i, 0);
+    childTable.v.resize(numOfBytes(chiArray.bitsPerItem, total));
+  }
 }
@@ -7,6 +7,10 @@
 #include <cassert>
 #include <cmath>
 
+#ifdef HAS_CXX_THREADS
+#include <thread>
+#endif
+
 namespace cbrc {
 
 void TantanMasker::init(bool isProtein,
@@ -59,4 +63,63 @@ T -5 -5 -5  2\n\
       probMatrix[i][j] = std::exp(stats.lambda() * s.caseInsensitive[i][j]);
 }
 
+// Get probabilities for numOfWindows consecutive windows, starting
+// at windowNum, each in its own thread
+void TantanMasker::getWindowProbabilities(const uchar *seqBeg,
+					  const uchar *seqEnd,
+					  size_t windowNum,
+					  unsigned numOfWindows,
+					  std::vector<float> *probabilities)
+  const {
+  if (numOfWindows > 1) {
+#ifdef HAS_CXX_THREADS
+    std::thread t(&TantanMasker::getWindowProbabilities, this,
+		  seqBeg, seqEnd, windowNum + 1, numOfWindows - 1,
+		  probabilities + 1);
+    getWindowProbabilities(seqBeg, seqEnd, windowNum, 1, probabilities);
+    t.join();
+#endif
+  } else {
+    size_t seqLen = seqEnd - seqBeg;
+    size_t beg = windowNum * windowStep;
+    size_t end = std::min(beg + windowStep + windowPad, seqLen);
+    beg -= std::min(beg, size_t(windowPad));
+    probabilities->resize(end - beg);
+    getProbabilities(seqBeg + beg, seqBeg + end, probabilities->data());
+  }
+}
+
+void TantanMasker::mask(uchar *seqBeg, uchar *seqEnd, const uchar *maskTable,
+			unsigned numOfThreads) const {
+  const double minMaskProb = 0.5;
+  size_t seqLen = seqEnd - seqBeg;
+
+  if (seqLen <= windowStep) {
+    std::vector<float> p(seqLen);
+    getProbabilities(seqBeg, seqEnd, p.data());
+    tantan::maskProbableLetters(seqBeg, seqEnd, p.data(), minMaskProb,
+				maskTable);
+    return;
+  }
+
+  size_t numOfWindows = (seqLen - 1) / windowStep + 1;
+  size_t maxThreads = std::max(numOfThreads, 1u);
+  std::vector< std::vector<float> > probs(std::min(maxThreads, numOfWindows));
+
+  for (size_t w = 0; w < numOfWindows; w += probs.size()) {
+    unsigned n = std::min(probs.size(), numOfWindows - w);
+    getWindowProbabilities(seqBeg, seqEnd, w, n, probs.data());
+    // Mask only after getting all the probabilities, because the
+    // windows overlap.  (The probabilities are insensitive to the
+    // masking, so it doesn't matter that later windows see it.)
+    for (unsigned i = 0; i < n; ++i) {
+      size_t beg = (w + i) * windowStep;
+      size_t end = std::min(beg + windowStep, seqLen);
+      const float *p = probs[i].data() + std::min(beg, size_t(windowPad));
+      tantan::maskProbableLetters(seqBeg + beg, seqBeg + end, p, minMaskProb,
+				  maskTable);
+    }
+  }
+}
+
 }
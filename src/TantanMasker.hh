@@ -24,6 +24,7 @@
 #include "ScoreMatrixRow.hh"
 #include "tantan.hh"
 #include <string>
+#include <vector>
 
 namespace cbrc {
 
@@ -38,16 +39,31 @@ public:
 	    const std::string &alphabet,
 	    const uchar *letterToIndex);
 
-  void mask(uchar *seqBeg, uchar *seqEnd, const uchar *maskTable) const {
-    tantan::maskSequences(seqBeg, seqEnd, maxRepeatOffset, probMatrixPointers,
-			  repeatProb, 0.05, 0.9, 0, 0, 0.5, maskTable);
-  }
+  // Sequences longer than windowStep are masked in overlapping
+  // windows: each window masks windowStep letters, but looks at
+  // windowPad more letters on each side.  Up to numOfThreads windows
+  // are done in parallel.  The result doesn't depend on numOfThreads.
+  enum { windowStep = 1 << 20, windowPad = 1 << 14 };
+
+  void mask(uchar *seqBeg, uchar *seqEnd, const uchar *maskTable,
+	    unsigned numOfThreads = 1) const;
 
 private:
   int maxRepeatOffset;
   double repeatProb;
   double probMatrix[scoreMatrixRowSize][scoreMatrixRowSize];
   double *probMatrixPointers[scoreMatrixRowSize];
+
+  void getProbabilities(const uchar *seqBeg, const uchar *seqEnd,
+			float *probabilities) const {
+    tantan::getProbabilities(seqBeg, seqEnd, maxRepeatOffset,
+			     probMatrixPointers, repeatProb, 0.05, 0.9, 0, 0,
+			     probabilities);
+  }
+
+  void getWindowProbabilities(const uchar *seqBeg, const uchar *seqEnd,
+			      size_t windowNum, unsigned numOfWindows,
+			      std::vector<float> *probabilities) const;
 };
 
 }
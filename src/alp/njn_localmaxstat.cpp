@@ -43,7 +43,7 @@ Contents:
 
 using namespace Njn;
 
-double LocalMaxStat::s_time = 0.0;
+thread_local double LocalMaxStat::s_time = 0.0;
 
 void LocalMaxStat::init (size_t dimension_)
 {
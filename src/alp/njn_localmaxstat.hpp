@@ -188,7 +188,7 @@ namespace Njn {
       // k for random walk : exponential prefactor 
       // expected renewal length for weak ladder epochs
 
-      static double s_time;
+      static thread_local double s_time;
 
     };
 
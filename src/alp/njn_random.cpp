@@ -50,7 +50,8 @@ namespace {
 
 	const size_t r_off = 12;
 
-	long	state [33] = {
+	// thread_local, so that ALP can run in several threads at once
+	thread_local long	state [33] = {
 	static_cast <long> (0xd53f1852),  static_cast <long> (0xdfc78b83),  static_cast <long> (0x4f256096),  static_cast <long> (0xe643df7),
 	static_cast <long> (0x82c359bf),  static_cast <long> (0xc7794dfa),  static_cast <long> (0xd5e9ffaa),  static_cast <long> (0x2c8cb64a),
 	static_cast <long> (0x2f07b334),  static_cast <long> (0xad5a7eb5),  static_cast <long> (0x96dc0cde),  static_cast <long> (0x6fc24589),
@@ -61,8 +62,8 @@ namespace {
 	static_cast <long> (0x25e9132c),  static_cast <long> (0xd0c6e906),  static_cast <long> (0xc2bc5b2d),  static_cast <long> (0x6c065c98),
 	static_cast <long> (0x6e37bd55)};
 
-   long	*rJ = &state [r_off];
-	long	*rK = &state [sizeof state / sizeof *state - 1];
+   thread_local long	*rJ = &state [r_off];
+	thread_local long	*rK = &state [sizeof state / sizeof *state - 1];
 
 }
 void Random::seed (long x)
@@ -13,21 +13,64 @@
 // it's easy to rewrite this code for those platforms.
 
 #include <fcntl.h>  // open
-#include <unistd.h>  // close
-#include <sys/mman.h>  // mmap, munmap
+#include <unistd.h>  // close, pread
+#include <sys/mman.h>  // mmap, munmap, shm_open
+#include <sys/stat.h>  // fstat, stat
+#include <cstdio>  // snprintf
+#include <cstdlib>  // realpath, free
+
+#ifdef __linux__
+#include <sys/syscall.h>  // SYS_set_mempolicy
+#endif
+
+#ifdef HAS_CXX_THREADS
+#include <thread>
+#endif
+
+#include <algorithm>  // min
+#include <vector>
 
 static void err( const std::string& s ) {
   throw std::runtime_error( s + ": " + std::strerror(errno) );
 }
 
+static int loadMethod = 0;  // 0=map, 1=copy, 2=huge, 3=shared
+static bool isInterleaveNodes = false;
+static unsigned numOfLoadThreads = 1;
+
+static const size_t hugePageSize = 1 << 21;
+
+static bool isCopied( int method ){
+  return method == 1 || method == 2;
+}
+
+// Size of the memory that we allocate for a file that isn't mapped
+static size_t allocatedSize( size_t bytes ){
+  return (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+}
+
+// Make this thread's new memory pages go round-robin on all NUMA
+// nodes (or not).  It's just a hint, so failure is ignored.
+static void setInterleave( bool isInterleave ){
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  const int mpolDefault = 0;
+  const int mpolInterleave = 3;
+  unsigned long allNodes = -1;
+  if( isInterleave )
+    syscall( SYS_set_mempolicy, mpolInterleave, &allNodes, 64 );
+  else
+    syscall( SYS_set_mempolicy, mpolDefault, 0, 0 );
+#endif
+}
+
 // This function tries to force the file-mapping to actually get
 // loaded into memory, by reading it sequentially.  Without this,
 // random access can be horribly slow (at least on two Linux 2.6
 // systems).
-static void primeMemory( void* begin, size_t bytes ){
+static void primeMemory( const char* begin, size_t bytes ){
   unsigned z = 0;
   size_t stepSize = 1024;
-  const char* x = static_cast<char*>(begin);
+  const char* x = begin;
   const char* y = x + (bytes / stepSize) * stepSize;
   while( x < y ){
     z += *x;
@@ -37,27 +80,172 @@ static void primeMemory( void* begin, size_t bytes ){
   dontOptimizeMeAway = dontOptimizeMeAway;  // ??? prevents compiler warning
 }
 
+// Copy part of a file into memory
+static bool readPart( char* dest, int fileDescriptor,
+		      size_t offset, size_t bytes ){
+  const size_t maxBytesPerRead = 1 << 30;
+  while( bytes > 0 ){
+    ssize_t r = pread( fileDescriptor, dest + offset,
+		       std::min( bytes, maxBytesPerRead ), offset );
+    if( r < 0 && errno == EINTR ) continue;
+    if( r <= 0 ) return false;
+    offset += r;
+    bytes -= r;
+  }
+  return true;
+}
+
+static void loadPart( char* m, int fileDescriptor, size_t bytes,
+		      size_t numOfParts, size_t partNum, char* isOk ){
+  if( isInterleaveNodes ) setInterleave( true );
+  size_t beg = bytes / numOfParts * partNum / hugePageSize * hugePageSize;
+  size_t end = (partNum + 1 < numOfParts)
+    ? bytes / numOfParts * (partNum + 1) / hugePageSize * hugePageSize
+    : bytes;
+  if( !isCopied( loadMethod ) ){
+    primeMemory( m + beg, end - beg );
+    isOk[partNum] = true;
+  } else {
+    isOk[partNum] = readPart( m, fileDescriptor, beg, end - beg );
+  }
+  if( isInterleaveNodes ) setInterleave( false );
+}
+
+// Load the parts of a file in parallel threads.  Each page goes to
+// the NUMA node of the thread that touches it first, unless we
+// interleave.
+static void loadParts( char* m, int fileDescriptor, size_t bytes,
+		       size_t numOfParts, size_t partNum, char* isOk ){
+#ifdef HAS_CXX_THREADS
+  if( partNum + 1 < numOfParts ){
+    std::thread t( loadPart, m, fileDescriptor, bytes,
+		   numOfParts, partNum, isOk );
+    loadParts( m, fileDescriptor, bytes, numOfParts, partNum + 1, isOk );
+    t.join();
+    return;
+  }
+  if( isInterleaveNodes ){  // don't change the main thread's policy
+    std::thread t( loadPart, m, fileDescriptor, bytes,
+		   numOfParts, partNum, isOk );
+    t.join();
+    return;
+  }
+#endif
+  loadPart( m, fileDescriptor, bytes, numOfParts, partNum, isOk );
+}
+
+// Map a copy of the file in shared memory, if lastdb-serve made one,
+// else return 0
+static void* attachSharedMemory( const std::string& fileName, size_t bytes ){
+  struct stat fileInfo;
+  if( stat( fileName.c_str(), &fileInfo ) < 0 ) return 0;
+  std::string name = cbrc::sharedMemoryName( fileName );
+  int f = shm_open( name.c_str(), O_RDONLY, 0 );
+  if( f < 0 ) return 0;
+  void* m = 0;
+  struct stat s;
+  // lastdb-serve makes it readable when it's completely copied
+  if( fstat( f, &s ) == 0 && (s.st_mode & S_IRUSR) &&
+      s.st_size == fileInfo.st_size && size_t(s.st_size) >= bytes ){
+    m = mmap( 0, bytes, PROT_READ, MAP_SHARED, f, 0 );
+    if( m == MAP_FAILED ) m = 0;
+  }
+  close(f);
+  return m;
+}
+
+static void* allocateMemory( size_t bytes ){
+  size_t size = allocatedSize( bytes );
+  void* m = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if( loadMethod == 2 ){
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+    m = mmap( 0, size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0 );
+  }
+#endif
+  if( m == MAP_FAILED ){  // e.g. if no huge pages were reserved
+    m = mmap( 0, size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( m == MAP_FAILED ) return m;
+#ifdef MADV_HUGEPAGE
+    madvise( m, size, MADV_HUGEPAGE );  // just a hint
+#endif
+  }
+  return m;
+}
+
 namespace cbrc{
 
+void setFileMapOptions( int method, bool isInterleave, unsigned numOfThreads ){
+  loadMethod = method;
+  isInterleaveNodes = isInterleave;
+  numOfLoadThreads = std::max( numOfThreads, 1u );
+}
+
+std::string sharedMemoryName( const std::string& fileName ){
+  struct stat s;
+  if( stat( fileName.c_str(), &s ) < 0 ) err( "can't open file " + fileName );
+  char* p = realpath( fileName.c_str(), 0 );
+  if( !p ) err( "can't open file " + fileName );
+  std::string path = p;
+  free(p);
+  // FNV-1a hash of the file's path, identity, size, and time
+  path += ' ' + stringify(s.st_dev) + ' ' + stringify(s.st_ino) + ' '
+    + stringify(s.st_size) + ' ' + stringify(s.st_mtime);
+  unsigned long long h = 14695981039346656037ULL;
+  for( size_t i = 0; i < path.size(); ++i ){
+    h ^= static_cast<unsigned char>( path[i] );
+    h *= 1099511628211ULL;
+  }
+  char name[32];
+  snprintf( name, sizeof name, "/last-%016llx", h );
+  return name;
+}
+
 void* openFileMap( const std::string& fileName, size_t bytes ){
   if( bytes == 0 ) return 0;
 
+  if( loadMethod == 3 ){
+    void* m = attachSharedMemory( fileName, bytes );
+    if( m ) return m;
+  }
+
   int f = open( fileName.c_str(), O_RDONLY );
   if( f < 0 ) err( "can't open file " + fileName );
 
-  void* m = mmap( 0, bytes, PROT_READ, MAP_SHARED, f, 0 );
-  if( m == MAP_FAILED ) err( "can't map file " + fileName );
+  void* m;
+  if( !isCopied( loadMethod ) ){
+    m = mmap( 0, bytes, PROT_READ, MAP_SHARED, f, 0 );
+    if( m == MAP_FAILED ) err( "can't map file " + fileName );
+  } else {
+    m = allocateMemory( bytes );
+    if( m == MAP_FAILED ) err( "can't allocate memory for file " + fileName );
+  }
+
+  const size_t minBytesPerPart = 1 << 24;
+  size_t numOfParts = std::min( size_t(numOfLoadThreads),
+				bytes / minBytesPerPart + 1 );
+  std::vector<char> isOk( numOfParts );
+  loadParts( static_cast<char*>(m), f, bytes, numOfParts, 0, &isOk[0] );
+  if( std::count( isOk.begin(), isOk.end(), 0 ) ){
+    if( isCopied( loadMethod ) ) munmap( m, allocatedSize( bytes ) );
+    err( "can't read file " + fileName );
+  }
+
+  if( isCopied( loadMethod ) ) mprotect( m, allocatedSize( bytes ), PROT_READ );
 
   int e = close(f);
   if( e < 0 ) err( "can't close file " + fileName );
 
-  primeMemory( m, bytes );
-
   return m;
 }
 
 void closeFileMap( void* begin, size_t bytes ){
   if( bytes == 0 ) return;
+  if( isCopied( loadMethod ) ) bytes = allocatedSize( bytes );
   int e = munmap( begin, bytes );
   if( e < 0 ) err( "failed to \"munmap\" " + stringify(bytes) + " bytes" );
 }
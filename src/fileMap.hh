@@ -10,6 +10,21 @@
 
 namespace cbrc{
 
+// Set how openFileMap puts files into memory.  Method 0: map the file.
+// 1: copy it into anonymous memory, with transparent huge pages if
+// possible.  2: copy it into explicit huge pages if possible (else do
+// method 1).  3: use a copy in shared memory made by lastdb-serve, if
+// there is one (else do method 0).  If isInterleave, spread the
+// memory over all NUMA nodes.
+// Files are loaded by up to numOfThreads threads.  This must not be
+// changed while files are open.
+void setFileMapOptions( int method, bool isInterleave, unsigned numOfThreads );
+
+// The name of the POSIX shared memory object, where lastdb-serve puts
+// a copy of the file.  It depends on the file's path, size, and
+// modification time, so a changed file won't match an old copy.
+std::string sharedMemoryName( const std::string& fileName );
+
 // Maps a file into memory, read-only, and returns a pointer to the
 // start of the mapping.  If it fails, it throws a runtime_error.  If
 // bytes is zero, it does nothing and returns 0.
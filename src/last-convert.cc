@@ -0,0 +1,465 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Read binary alignments written by lastal -f binary, and write them
+// in a text format, exactly as lastal would have.
+
+#include "mcf_alignment_records.hh"
+
+#include <getopt.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cstdlib>  // EXIT_SUCCESS, EXIT_FAILURE
+#include <iostream>
+#include <new>  // bad_alloc
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mcf;
+
+static const char mafFieldsLine[] =
+  "# name start alnSize strand seqSize alignment";
+
+static const char tabFieldsLine[] =
+  "# score\tname1\tstart1\talnSize1\tstrand1\tseqSize1\t"
+  "name2\tstart2\talnSize2\tstrand2\tseqSize2\tblocks";
+
+static const char coordinatesLine1[] =
+  "# Coordinates are 0-based.  For - strand matches, coordinates";
+
+static const char coordinatesLine2[] =
+  "# in the reverse complement of the 2nd sequence are used.";
+
+struct ConvertState {
+  char format;  // same as lastal's outputFormat
+  bool isEvalueHeader;
+  bool isSkipHashLine;
+  std::string out;
+};
+
+static char parseOutputFormat(const char *text) {
+  std::string s = text;
+  for (size_t i = 0; i < s.size(); ++i) s[i] = tolower(s[i]);
+  if (s == "tab" || s == "0") return 't';
+  if (s == "maf" || s == "1") return 'm';
+  if (s == "blasttab")        return 'b';
+  if (s == "blasttab+")       return 'B';
+  return 0;
+}
+
+static void append(std::string &out, const char *format, double x) {
+  char b[32];
+  out.append(b, snprintf(b, sizeof b, format, x));
+}
+
+static void appendSize(std::string &out, size_t x) {
+  char b[32];
+  out.append(b, snprintf(b, sizeof b, "%zu", x));
+}
+
+static size_t sizeWidth(size_t x) {
+  char b[32];
+  return snprintf(b, sizeof b, "%zu", x);
+}
+
+static void appendRight(std::string &out, size_t x, size_t width) {
+  out.append(width - sizeWidth(x), ' ');
+  appendSize(out, x);
+  out += ' ';
+}
+
+static void appendLeft(std::string &out, const char *s, size_t width) {
+  size_t len = strlen(s);
+  out.append(s, len);
+  out.append(width - len, ' ');
+  out += ' ';
+}
+
+static const char *scoreFormat(double fullScore) {
+  return fullScore >= 0 ? "%.0f" : "%.1f";
+}
+
+static void appendTags(std::string &out, const AlignmentRecordHead &h,
+		       char separator) {
+  if (h.isEvalue) {
+    out += separator;
+    out += "EG2=";
+    append(out, "%.2g", h.eg2);
+    out += separator;
+    out += "E=";
+    append(out, "%.2g", h.evalue);
+  }
+  if (h.fullScore > 0) {
+    out += separator;
+    out += "fullScore=";
+    append(out, "%.3g", h.fullScore);
+  }
+  out += '\n';
+}
+
+static void writeMaf(std::string &out, const AlignmentRecord &r) {
+  const cbrc::UnsplitAlignmentHead &a = r.aln;
+
+  if (r.head.fullScore >= -1) {
+    out += "a score=";
+    append(out, scoreFormat(r.head.fullScore), r.head.score);
+    appendTags(out, r.head, ' ');
+  }
+
+  size_t nw = std::max(strlen(r.rname), strlen(r.qname));
+  size_t bw = std::max(sizeWidth(a.rstart), sizeWidth(a.qstart));
+  size_t rw = std::max(sizeWidth(a.rspan), sizeWidth(a.qspan));
+  size_t sw = std::max(sizeWidth(a.rlength), sizeWidth(a.qlength));
+  size_t qLineBlankLen = bw + 1 + rw + 3 + sw + 1;
+  size_t pLineBlankLen = nw + 1 + qLineBlankLen;
+
+  out += "s ";
+  appendLeft(out, r.rname, nw);
+  appendRight(out, a.rstart, bw);
+  appendRight(out, a.rspan, rw);
+  out += a.rstrand;
+  out += ' ';
+  appendRight(out, a.rlength, sw);
+  out.append(r.ralign, r.alnLength);
+  out += '\n';
+
+  if (r.rqual) {
+    out += "q ";
+    appendLeft(out, r.rname, nw);
+    out.append(qLineBlankLen, ' ');
+    out.append(r.rqual, r.alnLength);
+    out += '\n';
+  }
+
+  out += "s ";
+  appendLeft(out, r.qname, nw);
+  appendRight(out, a.qstart, bw);
+  appendRight(out, a.qspan, rw);
+  out += a.qstrand;
+  out += ' ';
+  appendRight(out, a.qlength, sw);
+  out.append(r.qalign, r.alnLength);
+  out += '\n';
+
+  if (r.qqual) {
+    out += "q ";
+    appendLeft(out, r.qname, nw);
+    out.append(qLineBlankLen, ' ');
+    out.append(r.qqual, r.alnLength);
+    out += '\n';
+  }
+
+  if (r.probs) {
+    out += "p ";
+    out.append(pLineBlankLen, ' ');
+    out.append(r.probs, r.alnLength);
+    out += '\n';
+  }
+
+  if (r.cLine) {
+    out += r.cLine;
+    out += '\n';
+  }
+
+  out += '\n';
+}
+
+struct GaplessBlock {
+  size_t beg1, beg2, size;
+};
+
+// Get the gapless blocks from the aligned letters.  Between two
+// blocks, the MAF rows have all the unaligned reference letters, then
+// all the unaligned query letters.
+static void getBlocks(std::vector<GaplessBlock> &blocks,
+		      const AlignmentRecord &r) {
+  GaplessBlock b = {0, 0, 0};
+  size_t pos1 = 0;
+  size_t pos2 = 0;
+  bool isTopGap = false;
+  bool isBotGap = false;
+  blocks.clear();
+  for (size_t i = 0; i < r.alnLength; ++i) {
+    bool isTop = (r.ralign[i] != '-');
+    bool isBot = (r.qalign[i] != '-');
+    if (isTop && isBot) {
+      if (isTopGap || isBotGap) {
+	blocks.push_back(b);
+	b.beg1 = pos1;
+	b.beg2 = pos2;
+	b.size = 0;
+	isTopGap = isBotGap = false;
+      }
+      ++b.size;
+    } else if (isTop && isBotGap) {  // after a zero-size block
+      blocks.push_back(b);
+      b.beg1 = pos1;
+      b.beg2 = pos2;
+      b.size = 0;
+      isBotGap = false;
+    }
+    isTopGap |= (isTop && !isBot);
+    isBotGap |= (isBot && !isTop);
+    pos1 += isTop;
+    pos2 += isBot;
+  }
+  blocks.push_back(b);
+}
+
+static void writeTab(std::string &out, const AlignmentRecord &r,
+		     std::vector<GaplessBlock> &blocks) {
+  const cbrc::UnsplitAlignmentHead &a = r.aln;
+  const char t = '\t';
+
+  append(out, scoreFormat(r.head.fullScore), r.head.score);
+  out += t;
+  out += r.rname;
+  out += t;
+  appendSize(out, a.rstart);
+  out += t;
+  appendSize(out, a.rspan);
+  out += t;
+  out += a.rstrand;
+  out += t;
+  appendSize(out, a.rlength);
+  out += t;
+  out += r.qname;
+  out += t;
+  appendSize(out, a.qstart);
+  out += t;
+  appendSize(out, a.qspan);
+  out += t;
+  out += a.qstrand;
+  out += t;
+  appendSize(out, a.qlength);
+  out += t;
+
+  getBlocks(blocks, r);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const GaplessBlock &y = blocks[i];
+    if (i > 0) {
+      const GaplessBlock &x = blocks[i - 1];
+      if (x.size) out += ',';
+      appendSize(out, y.beg1 - (x.beg1 + x.size));
+      out += ':';
+      appendSize(out, y.beg2 - (x.beg2 + x.size));
+      if (y.size) out += ',';
+    }
+    if (y.size) appendSize(out, y.size);
+  }
+
+  appendTags(out, r.head, t);
+}
+
+static void writeBlastTab(std::string &out, const AlignmentRecord &r,
+			  std::vector<GaplessBlock> &blocks,
+			  bool isExtraColumns) {
+  const cbrc::UnsplitAlignmentHead &a = r.aln;
+  const char t = '\t';
+
+  size_t alignedColumns = 0;
+  size_t matches = 0;
+  for (size_t i = 0; i < r.alnLength; ++i) {
+    char x = r.ralign[i];
+    char y = r.qalign[i];
+    if (x != '-' && y != '-') {
+      ++alignedColumns;
+      if (toupper(x) == toupper(y)) ++matches;
+    }
+  }
+  getBlocks(blocks, r);
+
+  size_t beg1 = a.rstart + 1;  // 1-based coordinate
+  size_t end1 = a.rstart + a.rspan;
+  if (a.rstrand == '-') {
+    beg1 = a.rlength - a.rstart;
+    end1 = a.rlength - a.rstart - a.rspan + 1;
+  }
+  size_t beg2 = a.qstart + 1;
+  size_t end2 = a.qstart + a.qspan;
+  if (a.qstrand == '-') {
+    beg2 = a.qlength - a.qstart;
+    end2 = a.qlength - a.qstart - a.qspan + 1;
+  }
+
+  out += r.qname;
+  out += t;
+  out += r.rname;
+  out += t;
+  append(out, "%.2f", 100.0 * matches / r.alnLength);
+  out += t;
+  appendSize(out, r.alnLength);
+  out += t;
+  appendSize(out, alignedColumns - matches);
+  out += t;
+  appendSize(out, blocks.size() - 1);
+  out += t;
+  appendSize(out, beg2);
+  out += t;
+  appendSize(out, end2);
+  out += t;
+  appendSize(out, beg1);
+  out += t;
+  appendSize(out, end1);
+  if (r.head.isEvalue) {
+    out += t;
+    append(out, "%.2g", r.head.evalue);
+    out += t;
+    append(out, "%.3g", r.head.bitScore);
+  }
+  if (isExtraColumns) {
+    out += t;
+    appendSize(out, a.qlength);
+    out += t;
+    appendSize(out, a.rlength);
+    out += t;
+    append(out, scoreFormat(r.head.fullScore), r.head.score);
+  }
+  out += '\n';
+}
+
+// Write a header line, changing the parts that depend on the format
+static void writeTextLine(ConvertState &s, const char *line) {
+  bool isSkip = s.isSkipHashLine && !strcmp(line, "#");
+  s.isSkipHashLine = false;
+  if (isSkip) return;
+
+  if (s.format != 'm') {
+    bool isBlast = (s.format == 'b' || s.format == 'B');
+    if (!strncmp(line, "# lambda=", 9)) s.isEvalueHeader = true;
+    if (isBlast && !strcmp(line, coordinatesLine1)) return;
+    if (isBlast && !strcmp(line, coordinatesLine2)) {
+      s.isSkipHashLine = true;
+      return;
+    }
+    if (!strcmp(line, mafFieldsLine)) {
+      s.isSkipHashLine = true;
+      if (s.format == 't') {
+	s.out += tabFieldsLine;
+      } else {
+	s.out += "# Fields: query id, subject id, % identity, "
+	  "alignment length, mismatches, gap opens, q. start, q. end, "
+	  "s. start, s. end";
+	if (s.isEvalueHeader) s.out += ", evalue, bit score";
+	if (s.format == 'B') s.out += ", query length, subject length, "
+			       "raw score";
+      }
+      s.out += '\n';
+      return;
+    }
+  }
+
+  s.out += line;
+  s.out += '\n';
+}
+
+static void convertFile(ConvertState &s, const std::string &fileName) {
+  AlignmentRecordReader reader;
+  AlignmentRecord r;
+  std::vector<GaplessBlock> blocks;
+  size_t pos;
+  bool isRecord;
+
+  reader.open(fileName);
+  s.isEvalueHeader = false;
+  s.isSkipHashLine = false;
+
+  while (reader.next(pos, isRecord)) {
+    char *data = reader.at(pos);
+    if (!isRecord) {
+      writeTextLine(s, data);
+    } else {
+      parseAlignmentRecord(r, data);
+      if      (s.format == 'm') writeMaf(s.out, r);
+      else if (s.format == 't') writeTab(s.out, r, blocks);
+      else    writeBlastTab(s.out, r, blocks, s.format == 'B');
+    }
+    reader.discardBefore(pos);
+    if (s.out.size() >= 65536) {
+      std::cout.write(s.out.data(), s.out.size());
+      s.out.clear();
+    }
+  }
+
+  std::cout.write(s.out.data(), s.out.size());
+  s.out.clear();
+}
+
+static void run(int argc, char* argv[]) {
+  ConvertState s;
+  s.format = 'm';
+
+  const char *version = "last-convert "
+#include "version.hh"
+"\n";
+
+  std::string help = "\
+Usage: " + std::string(argv[0]) + " [options] binary-alignments-file(s)\n\
+\n\
+Read binary alignments from lastal -f binary, and write them as text.\n\
+\n\
+Options:\n\
+  -h, --help            show this help message and exit\n\
+  -f NAME, --format=NAME\n\
+                        output format: TAB, MAF, BlastTab, BlastTab+\n\
+                        (default: MAF)\n\
+  -V, --version         show version number and exit\n\
+";
+
+  const char sOpts[] = "hf:V";
+
+  static struct option lOpts[] = {
+    { "help",    no_argument,       0, 'h' },
+    { "format",  required_argument, 0, 'f' },
+    { "version", no_argument,       0, 'V' },
+    { 0, 0, 0, 0}
+  };
+
+  int c;
+  while ((c = getopt_long(argc, argv, sOpts, lOpts, &c)) != -1) {
+    switch (c) {
+    case 'h':
+      std::cout << help;
+      return;
+    case 'f':
+      s.format = parseOutputFormat(optarg);
+      if (!s.format) {
+	throw std::runtime_error("option -f: bad value: " +
+				 std::string(optarg));
+      }
+      break;
+    case 'V':
+      std::cout << version;
+      return;
+    case '?':
+      throw std::runtime_error("");
+    }
+  }
+
+  std::vector<std::string> fileNames(argv + optind, argv + argc);
+  if (fileNames.empty()) fileNames.push_back("-");
+
+  std::ios_base::sync_with_stdio(false);
+
+  for (size_t i = 0; i < fileNames.size(); ++i) {
+    convertFile(s, fileNames[i]);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    run(argc, argv);
+    if (!flush(std::cout)) throw std::runtime_error("write error");
+    return EXIT_SUCCESS;
+  } catch (const std::bad_alloc& e) {  // bad_alloc::what() may be unfriendly
+    std::cerr << argv[0] << ": out of memory\n";
+    return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    const char *s = e.what();
+    if (*s) std::cerr << argv[0] << ": " << s << '\n';
+    return EXIT_FAILURE;
+  }
+}
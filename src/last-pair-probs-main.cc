@@ -5,6 +5,7 @@
 
 #include "last-pair-probs.hh"
 #include "stringify.hh"
+#include "threadUtil.hh"
 
 #include <getopt.h>
 #include <cstdlib>  // EXIT_SUCCESS, EXIT_FAILURE
@@ -20,6 +21,7 @@ static void run(int argc, char* argv[]) {
   opts.isFraglen = false;
   opts.isSdev = false;
   opts.isDisjoint = false;
+  opts.numOfThreads = 1;
 
   const char *version = "last-pair-probs "
 #include "version.hh"
@@ -49,10 +51,12 @@ Options:\n\
   -c CHROM, --circular=CHROM\n\
                         specifies that chromosome CHROM is circular (default:\n\
                         chrM)\n\
+  -P N, --threads=N     number of parallel threads (0 = all cores) (default:\n\
+                        1)\n\
   -V, --version         show program's version number and exit\n\
 ";
 
-  const char sOpts[] = "hrem:f:s:d:c:V";
+  const char sOpts[] = "hrem:f:s:d:c:P:V";
 
   static struct option lOpts[] = {
     { "help",     no_argument,       0, 'h' },
@@ -63,6 +67,7 @@ Options:\n\
     { "sdev",     required_argument, 0, 's' },
     { "disjoint", required_argument, 0, 'd' },
     { "circular", required_argument, 0, 'c' },
+    { "threads",  required_argument, 0, 'P' },
     { "version",  no_argument,       0, 'V' },
     { 0, 0, 0, 0}
   };
@@ -105,6 +110,9 @@ Options:\n\
     case 'c':
       opts.circular.insert(optarg);
       break;
+    case 'P':
+      cbrc::unstringify(opts.numOfThreads, optarg);
+      break;
     case 'V':
       std::cout << version;
       return;
@@ -126,6 +134,9 @@ Options:\n\
   if (!opts.circular.size()) {
       opts.circular.insert("chrM");
   }
+  opts.numOfThreads =
+    cbrc::decideNumberOfThreads(opts.numOfThreads, argv[0], false);
+
   std::ios_base::sync_with_stdio(false);  // makes std::cin much faster!!!
 
   lastPairProbs(opts);
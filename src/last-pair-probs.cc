@@ -13,14 +13,27 @@
 #include <cstdlib>  // atof
 #include <cstring>  // strncmp
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <limits.h>
 #include <cfloat>
 #include <stddef.h>  // size_t
 
+#ifdef HAS_CXX_THREADS
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
+
 typedef const char *String;
 
+// How many times we saw each distance between paired reads.  This
+// stays small, even for huge inputs, because most pairs have similar
+// distances.
+typedef std::map<long, size_t> LengthCounts;
+
 static void err(const std::string& s) {
   throw std::runtime_error(s);
 }
@@ -189,7 +202,8 @@ static bool isGoodQueryName(const char *nameEnd) {
   return nameEnd[-2] == '/' && (nameEnd[-1] == '1' || nameEnd[-1] == '2');
 }
 
-static void printAlignmentWithMismapProb(const Alignment& alignment,
+static void printAlignmentWithMismapProb(std::ostream &out,
+					 const Alignment& alignment,
                                          double prob, const char *suf) {
   const String *linesBeg = alignment.linesBeg;
   const String *linesEnd = alignment.linesEnd;
@@ -202,10 +216,10 @@ static void printAlignmentWithMismapProb(const Alignment& alignment,
     const char *c = *linesBeg;
     const char *d = c;
     for (int i = 0; i < 7; ++i) d = skipWord(d);
-    std::cout.write(c, d - c);
-    std::cout << suf << d << "\tmismap=" << p << '\n';
+    out.write(c, d - c);
+    out << suf << d << "\tmismap=" << p << '\n';
   } else {  // we have MAF format
-    std::cout << *linesBeg << " mismap=" << p << '\n';
+    out << *linesBeg << " mismap=" << p << '\n';
     const char *pad = *suf ? "  " : "";  // spacer to keep the alignment of MAF lines
     const char *rName = alignment.rName;
     size_t rNameLen = skipWord(rName) - rName;
@@ -217,20 +231,20 @@ static void printAlignmentWithMismapProb(const Alignment& alignment,
       if (*c == 's' || *c == 'q') {
         if (*c == 's') s++;
         if (s == 1) {
-	  std::cout.write(c, rNameEnd);
-	  std::cout << pad << (c + rNameEnd) << '\n';
+	  out.write(c, rNameEnd);
+	  out << pad << (c + rNameEnd) << '\n';
         } else {
-	  std::cout.write(c, qNameEnd);
-	  std::cout << suf << (c + qNameEnd) << '\n';
+	  out.write(c, qNameEnd);
+	  out << suf << (c + qNameEnd) << '\n';
         }
       } else if (*c == 'p') {
-        std::cout.write(c, 1);
-        std::cout << pad << (c + 1) << '\n';
+        out.write(c, 1);
+        out << pad << (c + 1) << '\n';
       } else {
-        std::cout << c << '\n';
+        out << c << '\n';
       }
     }
-    std::cout << '\n';	// each MAF block should end with a blank line
+    out << '\n';	// each MAF block should end with a blank line
   }
 }
 
@@ -290,7 +304,8 @@ static void probForEachAlignment(const std::vector<Alignment>& alignments1,
   }
 }
 
-static void printAlnsForOneRead(const std::vector<Alignment>& alns1,
+static void printAlnsForOneRead(std::ostream &out,
+				const std::vector<Alignment>& alns1,
                                 const std::vector<Alignment>& alns2,
                                 const LastPairProbsOptions& opts,
                                 double maxMissingScore, const char *suf) {
@@ -317,13 +332,14 @@ static void printAlnsForOneRead(const std::vector<Alignment>& alns1,
 
   for (size_t i = 0; i < size1; ++i) {
     double prob = 1.0 - std::exp(zs[i] - zw);
-    if (prob <= opts.mismap) printAlignmentWithMismapProb(alns1[i], prob, suf);
+    if (prob <= opts.mismap)
+      printAlignmentWithMismapProb(out, alns1[i], prob, suf);
   }
 }
 
 static void unambiguousFragmentLengths(const std::vector<Alignment>& alns1,
                                        const std::vector<Alignment>& alns2,
-                                       std::vector<long>& lengths) {
+                                       LengthCounts& lengths) {
   // Returns the fragment length implied by alignments of a pair of reads.
   long oldLen = LONG_MAX;
   std::vector<Alignment>::const_iterator i, j;
@@ -338,7 +354,7 @@ static void unambiguousFragmentLengths(const std::vector<Alignment>& alns1,
       else if (newLen != oldLen) return;  // the fragment length is ambiguous
     }
   }
-  if (oldLen != LONG_MAX) lengths.push_back(oldLen);
+  if (oldLen != LONG_MAX) ++lengths[oldLen];
 }
 
 static AlignmentParameters readHeaderOrDie(std::istream& lines) {
@@ -539,7 +555,7 @@ static void parseBatch(const String *linesBeg, const String *linesEnd,
   stable_sort(alns.begin(), alns.end());
 }
 
-static void readQueryPairs1pass(std::vector<long> &lengths,
+static void readQueryPairs1pass(LengthCounts &lengths,
 				const std::vector<const String *> &batchEnds,
 				double scale1, double scale2,
 				const std::set<std::string> &circularChroms) {
@@ -551,15 +567,16 @@ static void readQueryPairs1pass(std::vector<long> &lengths,
   }
 }
 
-static void readQueryPairs2pass(const std::vector<const String *> &batchEnds,
+static void readQueryPairs2pass(std::ostream &out,
+				const std::vector<const String *> &batchEnds,
                                 double scale1, double scale2,
                                 const LastPairProbsOptions& opts) {
   std::vector<Alignment> a1, a2;
   for (size_t i = 1; i+1 < batchEnds.size(); i += 2) {
     parseBatch(batchEnds[i-1], batchEnds[i], '+', scale1, opts.circular, a1);
     parseBatch(batchEnds[i], batchEnds[i+1], '-', scale2, opts.circular, a2);
-    printAlnsForOneRead(a1, a2, opts, opts.maxMissingScore1, "/1");
-    printAlnsForOneRead(a2, a1, opts, opts.maxMissingScore2, "/2");
+    printAlnsForOneRead(out, a1, a2, opts, opts.maxMissingScore1, "/1");
+    printAlnsForOneRead(out, a2, a1, opts, opts.maxMissingScore2, "/2");
   }
 }
 
@@ -569,17 +586,25 @@ static double myRound(double myFloat) {
   return std::atof(buf);
 }
 
-static void estimateFragmentLengthDistribution(std::vector<long> lengths,
+// The length at this (0-based) rank, if all the lengths were sorted
+static long lengthAtRank(const LengthCounts &lengths, size_t rank) {
+  LengthCounts::const_iterator i;
+  for (i = lengths.begin(); rank >= i->second; ++i) rank -= i->second;
+  return i->first;
+}
+
+static void estimateFragmentLengthDistribution(const LengthCounts& lengths,
                                                LastPairProbsOptions& opts) {
   if (lengths.empty())
     err("can't estimate the distribution of distances");
 
   // Define quartiles in the most naive way possible:
-  std::sort(lengths.begin(), lengths.end());
-  const size_t sampleSize = lengths.size();
-  const long quartile1 = lengths[sampleSize / 4];
-  const long quartile2 = lengths[sampleSize / 2];
-  const long quartile3 = lengths[sampleSize * 3 / 4];
+  size_t sampleSize = 0;
+  LengthCounts::const_iterator i;
+  for (i = lengths.begin(); i != lengths.end(); ++i) sampleSize += i->second;
+  const long quartile1 = lengthAtRank(lengths, sampleSize / 4);
+  const long quartile2 = lengthAtRank(lengths, sampleSize / 2);
+  const long quartile3 = lengthAtRank(lengths, sampleSize * 3 / 4);
 
   std::cout << "# distance sample size: " << sampleSize << "\n";
   std::cout << "# distance quartiles: "
@@ -642,6 +667,140 @@ static void skipOneBatchMarker(std::istream& input) {
     if (line.find("# batch ") == 0) break;
 }
 
+// Alignments of several read pairs.  We read these on the main
+// thread, and maybe calculate their probabilities on other threads,
+// but always write the output in the input order.
+struct PairChunk {
+  std::vector<char> text;
+  std::vector<String> lines;
+  std::vector<const String *> batchEnds;
+  std::string output;
+#ifdef HAS_CXX_THREADS
+  std::exception_ptr error;
+#endif
+  bool isDone;
+  PairChunk() : isDone(false) {}
+};
+
+struct PairPipeline {
+  std::vector<PairChunk> chunks;  // used in turn, round and round
+  size_t numOfRead;
+  size_t numOfFilled;  // chunks given to the calculating threads
+  size_t numOfTaken;   // chunks taken by the calculating threads
+  size_t numOfWritten;
+  const LastPairProbsOptions *opts;
+  double scale1;
+  double scale2;
+#ifdef HAS_CXX_THREADS
+  bool isEndOfInput;
+  std::mutex mutex;
+  std::condition_variable isFilled;
+  std::condition_variable isDone;
+  std::vector<std::thread> threads;
+  ~PairPipeline();
+#endif
+};
+
+static const int pairsPerChunk = 1000;
+
+// We estimate the distance distribution from this many chunks (if
+// it's not given), so we keep them all before writing anything
+static const size_t numOfFirstChunks = 100;
+
+#ifdef HAS_CXX_THREADS
+static void calculateChunks(PairPipeline *p) {
+  for (;;) {
+    PairChunk *c;
+    {
+      std::unique_lock<std::mutex> lock(p->mutex);
+      while (p->numOfTaken == p->numOfFilled && !p->isEndOfInput) {
+	p->isFilled.wait(lock);
+      }
+      if (p->numOfTaken == p->numOfFilled) return;
+      c = &p->chunks[p->numOfTaken++ % p->chunks.size()];
+    }
+    try {
+      std::ostringstream out;
+      readQueryPairs2pass(out, c->batchEnds, p->scale1, p->scale2, *p->opts);
+      c->output = out.str();
+    } catch (...) {
+      c->error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(p->mutex);
+    c->isDone = true;
+    p->isDone.notify_all();
+  }
+}
+
+static void stopPairThreads(PairPipeline &p) {
+  {
+    std::lock_guard<std::mutex> lock(p.mutex);
+    p.isEndOfInput = true;
+  }
+  p.isFilled.notify_all();
+  for (size_t i = 0; i < p.threads.size(); ++i) p.threads[i].join();
+  p.threads.clear();
+}
+
+PairPipeline::~PairPipeline() {  // in case we stopped due to an error
+  stopPairThreads(*this);
+}
+#endif
+
+static void startPairPipeline(PairPipeline &p, unsigned numOfThreads,
+			      const LastPairProbsOptions &opts,
+			      double scale1, double scale2) {
+  p.opts = &opts;
+  p.scale1 = scale1;
+  p.scale2 = scale2;
+#ifdef HAS_CXX_THREADS
+  if (numOfThreads > 1) {
+    for (unsigned i = 0; i < numOfThreads; ++i) {
+      p.threads.push_back(std::thread(calculateChunks, &p));
+    }
+  }
+#endif
+}
+
+static void writeOldestChunk(PairPipeline &p) {
+  PairChunk &c = p.chunks[p.numOfWritten % p.chunks.size()];
+#ifdef HAS_CXX_THREADS
+  {
+    std::unique_lock<std::mutex> lock(p.mutex);
+    while (!c.isDone) p.isDone.wait(lock);
+  }
+  if (c.error) std::rethrow_exception(c.error);
+#endif
+  std::cout << c.output;
+  c.output.clear();
+  c.isDone = false;
+  ++p.numOfWritten;
+}
+
+// Calculate and write the oldest chunk that we read, or give it to
+// the calculating threads
+static void submitChunk(PairPipeline &p) {
+#ifdef HAS_CXX_THREADS
+  if (!p.threads.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(p.mutex);
+      ++p.numOfFilled;
+    }
+    p.isFilled.notify_one();
+    return;
+  }
+#endif
+  PairChunk &c = p.chunks[p.numOfFilled++ % p.chunks.size()];
+  readQueryPairs2pass(std::cout, c.batchEnds, p.scale1, p.scale2, *p.opts);
+  ++p.numOfWritten;
+}
+
+static bool readChunk(PairPipeline &p, std::istream &in1, std::istream &in2) {
+  if (p.numOfRead == p.numOfWritten + p.chunks.size()) writeOldestChunk(p);
+  PairChunk &c = p.chunks[p.numOfRead++ % p.chunks.size()];
+  return readBatches(in1, in2, c.text, c.lines, c.batchEnds, pairsPerChunk);
+}
+
 void lastPairProbs(LastPairProbsOptions& opts) {
   const std::vector<std::string>& inputs = opts.inputFileNames;
   size_t n = inputs.size();
@@ -651,7 +810,7 @@ void lastPairProbs(LastPairProbsOptions& opts) {
   std::vector<char> text;
   std::vector<String> lines;
   std::vector<const String *> batchEnds;
-  std::vector<long> lengths;
+  LengthCounts lengths;
 
   mcf::izstream inFile1, inFile2;
   std::istream& in1 =
@@ -662,7 +821,7 @@ void lastPairProbs(LastPairProbsOptions& opts) {
   if (opts.estdist) {
     if (n < 2) skipOneBatchMarker(in1);
     while (1) {
-      bool ok = readBatches(in1, in2, text, lines, batchEnds, 1);
+      bool ok = readBatches(in1, in2, text, lines, batchEnds, pairsPerChunk);
       readQueryPairs1pass(lengths, batchEnds, 1.0, 1.0, opts.circular);
       if (!ok) break;
     }
@@ -671,10 +830,21 @@ void lastPairProbs(LastPairProbsOptions& opts) {
     AlignmentParameters params1 = readHeaderOrDie(in1);
     AlignmentParameters params2 = (n > 1) ? readHeaderOrDie(in2) : params1;
     if (n < 2) skipOneBatchMarker(in1);
-    bool ok = readBatches(in1, in2, text, lines, batchEnds, 100000);
+
+    PairPipeline p;
+    p.chunks.resize(std::max(numOfFirstChunks, opts.numOfThreads * 2UL));
+    p.numOfRead = p.numOfFilled = p.numOfTaken = p.numOfWritten = 0;
+#ifdef HAS_CXX_THREADS
+    p.isEndOfInput = false;
+#endif
+    bool ok = true;
+    while (ok && p.numOfRead < numOfFirstChunks) ok = readChunk(p, in1, in2);
 
     if (!opts.isFraglen || !opts.isSdev) {
-      readQueryPairs1pass(lengths, batchEnds, 1.0, 1.0, opts.circular);
+      for (size_t i = 0; i < p.numOfRead; ++i) {
+	readQueryPairs1pass(lengths, p.chunks[i].batchEnds,
+			    1.0, 1.0, opts.circular);
+      }
       estimateFragmentLengthDistribution(lengths, opts);
     }
 
@@ -683,10 +853,14 @@ void lastPairProbs(LastPairProbsOptions& opts) {
               << " sdev=" << opts.sdev
               << " disjoint=" << opts.disjoint
               << " genome=" << params1.gGet() << "\n";
-    readQueryPairs2pass(batchEnds, params1.tGet(), params2.tGet(), opts);
+
+    startPairPipeline(p, opts.numOfThreads, opts,
+		      params1.tGet(), params2.tGet());
+    while (p.numOfFilled < p.numOfRead) submitChunk(p);
     while (ok) {
-      ok = readBatches(in1, in2, text, lines, batchEnds, 1);
-      readQueryPairs2pass(batchEnds, params1.tGet(), params2.tGet(), opts);
+      ok = readChunk(p, in1, in2);
+      submitChunk(p);
     }
+    while (p.numOfWritten < p.numOfFilled) writeOldestChunk(p);
   }
 }
@@ -40,6 +40,7 @@ struct LastPairProbsOptions {
   double disjoint;
   std::set<std::string> circular;
   std::vector<std::string> inputFileNames;
+  unsigned numOfThreads;
   double outer;
   double inner;
   double disjointScore;
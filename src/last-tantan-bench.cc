@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Time tantan repeat-finding on DNA, using each SIMD tier that this
+// CPU can run.  The DNA is read from a FASTA file, or is random with
+// some tandem repeats if no file is given.  This is a developer tool:
+// it is built by "make bench", not "make".
+
+#include "tantan.hh"
+#include "mcf_simd.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mcf;
+
+typedef unsigned char uchar;
+typedef std::chrono::steady_clock Clock;
+
+static const int seqLen = 10000000;
+static const int maxRepeatOffset = 100;  // lastdb's default for DNA
+static const uchar delimiter = 4;
+
+static void makeRandomSeq(std::vector<uchar> &s) {
+  while (s.size() < seqLen) {
+    int len = 100 + std::rand() % 10000;
+    if (std::rand() % 20) {
+      for (int i = 0; i < len; ++i) s.push_back(std::rand() % 4);
+    } else {
+      std::vector<uchar> unit(1 + std::rand() % maxRepeatOffset);
+      for (size_t i = 0; i < unit.size(); ++i) unit[i] = std::rand() % 4;
+      for (int i = 0; i < len; ++i) {
+	bool isMutate = (std::rand() % 10 == 0);
+	s.push_back(isMutate ? std::rand() % 4 : unit[i % unit.size()]);
+      }
+    }
+  }
+}
+
+static void readFastaSeqs(const char *fileName, std::vector<uchar> &s) {
+  std::ifstream f(fileName);
+  if (!f) {
+    std::cerr << "last-tantan-bench: can't open " << fileName << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.empty()) continue;
+    if (line[0] == '>') {
+      s.push_back(delimiter);
+      continue;
+    }
+    for (size_t i = 0; i < line.size(); ++i) {
+      switch (line[i]) {
+      case 'A': case 'a': s.push_back(0); break;
+      case 'C': case 'c': s.push_back(1); break;
+      case 'G': case 'g': s.push_back(2); break;
+      case 'T': case 't': s.push_back(3); break;
+      default: s.push_back(delimiter);
+      }
+    }
+  }
+}
+
+static double seconds(Clock::time_point beg) {
+  return std::chrono::duration<double>(Clock::now() - beg).count();
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<uchar> seq;
+  if (argc > 1) {
+    readFastaSeqs(argv[1], seq);
+  } else {
+    makeRandomSeq(seq);
+  }
+
+  // likelihood ratios for match score +1, mismatch score -1
+  const int matrixSize = delimiter + 1;
+  double matrix[matrixSize][matrixSize];
+  const double *matrixPtrs[matrixSize];
+  for (int i = 0; i < matrixSize; ++i) {
+    for (int j = 0; j < matrixSize; ++j) {
+      bool isLetters = (i < 4 && j < 4);
+      matrix[i][j] = !isLetters ? 1 : i == j ? 3 : 1.0 / 3;
+    }
+    matrixPtrs[i] = matrix[i];
+  }
+
+  std::vector<float> probs(seq.size());
+  const uchar *beg = seq.data();
+  const uchar *end = beg + seq.size();
+
+#if MCF_SIMD_DISPATCH
+  const int maxTier = simdTier();
+#else
+  const int maxTier = 0;
+#endif
+  size_t firstMaskCount = 0;
+
+  for (int tier = maxTier; tier >= 0; --tier) {
+#if MCF_SIMD_DISPATCH
+    simdTier() = tier;
+#endif
+    Clock::time_point t = Clock::now();
+    tantan::getProbabilities(beg, end, maxRepeatOffset, matrixPtrs,
+			     0.005, 0.05, 0.9, 0, 0, probs.data());
+    double time = seconds(t);
+
+    size_t maskCount = 0;
+    for (size_t i = 0; i < probs.size(); ++i) {
+      maskCount += (probs[i] >= 0.5);
+    }
+
+    std::cout << "tier " << tier << "\tletters " << seq.size()
+	      << "\tmasked " << maskCount << "\t" << time << "s\n";
+
+    if (tier == maxTier) {
+      firstMaskCount = maskCount;
+    } else if (maskCount != firstMaskCount) {
+      std::cerr << "last-tantan-bench: masking differs between tiers\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
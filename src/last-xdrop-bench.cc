@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Time the gapped x-drop kernels, on random DNA sequences, using each
+// SIMD tier that this CPU can run.  This is a developer tool: it is
+// built by "make bench", not "make".
+
+#include "GappedXdropAligner.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace cbrc;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int seqLen = 100000;
+static const int numReps = 20;
+static const uchar delimiter = 4;
+
+// Append a random sequence to s1, and a mutated copy of it to s2
+static void makeSeqs(std::vector<uchar> &s1, std::vector<uchar> &s2) {
+  s1.push_back(delimiter);
+  s2.push_back(delimiter);
+  for (int i = 0; i < seqLen; ++i) {
+    uchar x = std::rand() % 4;
+    s1.push_back(x);
+    int r = std::rand() % 100;
+    if (r < 8) s2.push_back((x + 1 + std::rand() % 3) % 4);
+    else if (r < 9) continue;
+    else if (r < 10) s2.push_back(std::rand() % 4);
+    s2.push_back(x);
+  }
+  s1.push_back(delimiter);
+  s2.push_back(delimiter);
+}
+
+static double seconds(Clock::time_point beg) {
+  return std::chrono::duration<double>(Clock::now() - beg).count();
+}
+
+int main() {
+  const int match = 1;
+  const int mismatch = -1;
+  const int gapOpen = 7;
+  const int gapGrow = 1;
+  const int maxDrop = 30;
+
+  std::vector<ScoreMatrixRow> scorer(ALPHABET_CAPACITY);
+  std::vector<uchar> toUnmasked(256);
+  for (int i = 0; i < ALPHABET_CAPACITY; ++i) {
+    for (int j = 0; j < ALPHABET_CAPACITY; ++j) {
+      bool isLetters = (i < 4 && j < 4);
+      scorer[i][j] = !isLetters ? delimiterScore : i == j ? match : mismatch;
+    }
+  }
+  for (int i = 0; i < 256; ++i) toUnmasked[i] = i;
+
+  std::vector<uchar> s1, s2;
+  makeSeqs(s1, s2);
+  BigSeq seq1 = {&s1[0], false};
+
+  GappedXdropAligner aligner;
+
+#if MCF_SIMD_DISPATCH
+  const int maxTier = simdTier();
+#else
+  const int maxTier = 0;
+#endif
+  int firstDnaScore = 0;
+  int firstScore = 0;
+
+  for (int tier = maxTier; tier >= 0; --tier) {
+#if MCF_SIMD_DISPATCH
+    simdTier() = tier;
+#endif
+    int dnaScore = 0;
+    Clock::time_point beg = Clock::now();
+    for (int i = 0; i < numReps; ++i) {
+      dnaScore = aligner.alignDna(seq1 + 1, &s2[1], true, &scorer[0],
+				  gapOpen, gapGrow, gapOpen, gapGrow,
+				  maxDrop, match, &toUnmasked[0]);
+    }
+    double dnaTime = seconds(beg);
+
+    int score = 0;
+    beg = Clock::now();
+    for (int i = 0; i < numReps; ++i) {
+      score = aligner.align(seq1 + 1, &s2[1], true, 0, &scorer[0],
+			    gapOpen, gapGrow, gapOpen, gapGrow,
+			    INF, true, maxDrop, match);
+    }
+    double time = seconds(beg);
+
+    std::cout << "tier " << tier << "\talignDna " << dnaScore << " "
+	      << dnaTime << "s\talign " << score << " " << time << "s\n";
+
+    if (tier == maxTier) {
+      firstDnaScore = dnaScore;
+      firstScore = score;
+    } else if (dnaScore != firstDnaScore || score != firstScore) {
+      std::cerr << "last-xdrop-bench: score mismatch between tiers\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -21,19 +21,28 @@
 #include "gaplessTwoQualityXdrop.hh"
 #include "mcf_substitution_matrix_stats.hh"
 #include "zio.hh"
+#include "mcf_alignment_records.hh"
 #include "stringify.hh"
 #include "threadUtil.hh"
 #include "split/mcf_last_splitter.hh"
 
+#include <errno.h>
 #include <math.h>
 #include <signal.h>
 #include <stdlib.h>  // EXIT_SUCCESS, EXIT_FAILURE
+#include <string.h>  // strlen
+#include <sys/uio.h>  // writev
+#include <unistd.h>  // STDOUT_FILENO
 
 #include <iomanip>  // setw
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 
 #define ERR(x) throw std::runtime_error(x)
@@ -48,17 +57,72 @@ using namespace cbrc;
 
 typedef unsigned long long countT;
 
+const unsigned maxNumOfIndexes = 16;
+
+struct LastVolume {  // a database volume, and data that depends on it
+  MultiSequence refSeqs;  // sequence that has been indexed by lastdb
+  SubsetSuffixArray suffixArrays[maxNumOfIndexes];
+  DnaWordsFinder wordsFinder;
+  int minScoreGapless;
+  unsigned volumeNumber = -1;  // which volume is loaded here, if any
+};
+
+// An alignment that hasn't been written as text yet
+struct PendingAlignment {
+  AlignmentText key;  // query coordinates and score, but no text
+  Alignment aln;
+  AlignmentExtras extras;
+};
+
 struct LastAligner {  // data that changes between queries
+  const LastVolume *volume;  // the database volume we're aligning to
   Aligners engines;
   LastSplitter splitter;
   std::vector<int> qualityPssm;
   std::vector<AlignmentText> textAlns;
+  mcf::Arena textArena;  // memory for the text of textAlns
+  std::vector<PendingAlignment> pendingAlns;
+  bool isCullBeforeWriting = false;  // put alignments in pendingAlns?
+  size_t numOfOldAlns = 0;  // textAlns from previous volumes, sorted for culling
   std::vector<char *> alignmentTextLines;
   std::vector< std::vector<countT> > matchCounts;  // used if outputType == 0
   countT numOfNormalLetters;
   countT numOfSequences;
 };
 
+struct QueryChunk {  // results for some query sequences in one batch
+  std::vector<AlignmentText> textAlns;
+  mcf::Arena textArena;
+  std::vector< std::vector<countT> > matchCounts;  // used if outputType == 0
+  std::vector<char> splitOutput;
+  bool isDone;  // finished aligning to the current volume?
+};
+
+struct QueryBatch {  // a batch of query sequences, and its output
+  MultiSequence qrySeqs;
+  countT serialNum;  // this is the n-th batch read from the input
+  std::vector<AlignmentText> textAlns;
+  mcf::Arena textArena;
+  std::vector<char> text;  // split alignments or match counts
+};
+
+// Batches of query sequences are passed from a reader thread, to
+// aligner threads, to a writer thread.  The number of batches is
+// fixed, so the reader can't get far ahead of the writer.
+struct QueryPipeline {
+  std::mutex mutex;
+  std::condition_variable isFree;
+  std::condition_variable isRead;
+  std::condition_variable isAligned;
+  std::vector<QueryBatch> batches;
+  std::vector<size_t> freeBatches;
+  std::deque<size_t> readBatches;
+  std::vector<size_t> alignedBatches;
+  countT numOfReadBatches;
+  countT numOfWrittenBatches;
+  bool isEndOfInput;
+};
+
 struct SubstitutionMatrices {
   mcf::SubstitutionMatrixStats stats;
   QualityPssmMaker maker;
@@ -106,20 +170,20 @@ namespace {
   TantanMasker tantanMasker;
   GeneticCode geneticCode;
   SplitAlignerParams splitParams;
-  const unsigned maxNumOfIndexes = 16;
-  SubsetSuffixArray suffixArrays[maxNumOfIndexes];
-  DnaWordsFinder wordsFinder;
   ScoreMatrix scoreMatrix;
   SubstitutionMatrices fwdMatrices;
   SubstitutionMatrices revMatrices;
   mcf::GapCosts gapCosts;
   std::vector<LastAligner> aligners;
+  std::vector<QueryChunk> queryChunks;
+  QueryPipeline queryPipeline;
+  std::atomic<size_t> nextQueryChunk;  // next chunk for a thread to take
+  size_t nextChunkToPrint;
   LastEvaluer evaluer;
   LastEvaluer gaplessEvaluer;
   MultiSequence qrySeqsGlobal;  // sequence that hasn't been indexed by lastdb
-  MultiSequence refSeqs;  // sequence that has been indexed by lastdb
+  std::vector<LastVolume> volumes;  // database volumes in memory
   sequenceFormat::Enum referenceFormat = sequenceFormat::fasta;
-  int minScoreGapless;
   unsigned numOfVolumes = -1;
   unsigned numOfIndexes = 1;  // assume this value, if unspecified
 }
@@ -362,7 +426,8 @@ static void calculateScoreStatistics(const std::string &matrixName) {
 		   alph.letters.c_str(), scoreMat, p1, p2, isGapped,
 		   del.openCost, del.growCost, ins.openCost, ins.growCost,
 		   fsCost, geneticCode,
-		   args.geneticCodeFile.c_str(), args.verbosity);
+		   args.geneticCodeFile.c_str(), args.verbosity,
+		   aligners.size(), args.evalueCacheFile);
     }
     if( args.verbosity > 0 ) evaluer.writeParameters( std::cerr );
   }catch( const Sls::error& e ){
@@ -464,35 +529,38 @@ void readInnerPrj(const std::string &fileName,
   if( !f ) ERR( "can't read file: " + fileName );
 }
 
-static size_t seedSearchEnd(size_t seqEnd) {
-  size_t d = wordsFinder.wordLength ? wordsFinder.wordLength : 1;
+static size_t seedSearchEnd(const LastVolume &vol, size_t seqEnd) {
+  size_t d = vol.wordsFinder.wordLength ? vol.wordsFinder.wordLength : 1;
   size_t x = args.minHitDepth - std::min(d, args.minHitDepth);
   return seqEnd - std::min(x, seqEnd);
 }
 
 // Write match counts for each query sequence
 void writeCounts(const std::vector< std::vector<countT> > &matchCounts,
-		 const MultiSequence &qrySeqs, size_t firstSequence) {
+		 const MultiSequence &qrySeqs, size_t firstSequence,
+		 std::ostream &out) {
   for (size_t i = 0; i < matchCounts.size(); ++i) {
-    std::cout << qrySeqs.seqName(firstSequence + i) << '\n';
+    out << qrySeqs.seqName(firstSequence + i) << '\n';
     for (size_t j = args.minHitDepth; j < matchCounts[i].size(); ++j) {
-      std::cout << j << '\t' << matchCounts[i][j] << '\n';
+      out << j << '\t' << matchCounts[i][j] << '\n';
     }
-    std::cout << '\n';  // blank line afterwards
+    out << '\n';  // blank line afterwards
   }
 }
 
 // Count all matches, of all sizes, of a query sequence against a suffix array
-void countMatches(std::vector<countT> &counts, const SeqData &qryData) {
-  if (wordsFinder.wordLength) {  // YAGNI
+void countMatches(std::vector<countT> &counts, const LastVolume &vol,
+		  const SeqData &qryData) {
+  if (vol.wordsFinder.wordLength) {  // YAGNI
     err("can't count initial matches with word-restricted seeds, sorry");
   }
-  size_t loopEnd = seedSearchEnd(qryData.seqEnd);
+  size_t loopEnd = seedSearchEnd(vol, qryData.seqEnd);
 
   for (size_t i = qryData.seqBeg; i < loopEnd; i += args.queryStep) {
     for (unsigned x = 0; x < numOfIndexes; ++x) {
-      suffixArrays[x].countMatches(counts, qryData.seq + i,
-				   refSeqs.seqPtr(), 0, args.maxHitDepth);
+      vol.suffixArrays[x].countMatches(counts, qryData.seq + i,
+				       vol.refSeqs.seqPtr(), 0,
+				       args.maxHitDepth);
     }
   }
 }
@@ -538,8 +606,8 @@ struct Dispatcher{
   int d;  // the maximum score drop
   int z;
 
-  Dispatcher(Phase::Enum e, const SeqData &qryData,
-	     const SubstitutionMatrices &matrices) :
+  Dispatcher(Phase::Enum e, const MultiSequence &refSeqs,
+	     const SeqData &qryData, const SubstitutionMatrices &matrices) :
       a( refSeqs.seqPtr() ),
       b( qryData.seq ),
       i( refSeqs.qualityReader() ),
@@ -592,19 +660,48 @@ static bool isCollatedAlignments() {
     || args.cullingLimitForFinalAlignments + 1 || numOfVolumes > 1;
 }
 
+// Can we give alignments to the splitter directly, without MAF text?
+static bool isSplitWithoutMaf(const MultiSequence &refSeqs) {
+  return args.isSplit && !args.splitOpts.no_split && !refSeqs.qualsPerLetter();
+}
+
+// The size of an alignment's text, which may be a binary record
+static size_t alignmentTextSize(const char *text) {
+  if (*text) return strlen(text);
+  uint32_t recordSize;
+  memcpy(&recordSize, text + 1, sizeof recordSize);
+  return mcf::recordPrefixSize + recordSize;
+}
+
+static void printAlignment(const char *text) {
+  std::cout.write(text, alignmentTextSize(text));
+}
+
 static void writeAlignment(LastAligner &aligner, const MultiSequence &qrySeqs,
 			   const SeqData &qryData, const Alignment &aln,
 			   const AlignmentExtras &extras = AlignmentExtras()) {
   int translationType = scoreMatrix.isCodonCols() ? 2 : args.isTranslated();
-  AlignmentText a = aln.write(refSeqs, qrySeqs, qryData.seqNum, qryData.seq,
-			      alph, queryAlph,
-			      translationType, geneticCode.getCodonToAmino(),
-			      evaluer, args.outputFormat, extras);
+  if (aligner.isCullBeforeWriting) {
+    aligner.pendingAlns.resize(aligner.pendingAlns.size() + 1);
+    PendingAlignment &p = aligner.pendingAlns.back();
+    p.key = aln.textKey(qrySeqs, qryData.seqNum, translationType);
+    p.aln = aln;
+    p.extras = extras;
+    return;
+  }
+  const MultiSequence &refSeqs = aligner.volume->refSeqs;
+  AlignmentText a = isSplitWithoutMaf(refSeqs)
+    ? aln.writeForSplit(refSeqs, qrySeqs, qryData.seqNum, qryData.seq,
+			alph, extras, aligner.textArena)
+    : aln.write(refSeqs, qrySeqs, qryData.seqNum, qryData.seq,
+		alph, queryAlph,
+		translationType, geneticCode.getCodonToAmino(),
+		evaluer, args.outputFormat, extras, aligner.textArena);
   if (isCollatedAlignments() || aligners.size() > 1) {
     aligner.textAlns.push_back(a);
   } else {
-    std::cout << a.text;
-    delete[] a.text;
+    printAlignment(a.text);
+    aligner.textArena.unwind(a.text);
   }
 }
 
@@ -623,28 +720,83 @@ struct GaplessAlignmentCounts {
   size_t maxSignificantAlignments;
 };
 
-// Get seed hits and gapless alignments at one query-sequence position
+// Query-sequence positions whose seed hits get looked up together
+struct SeedBatch {
+  enum { capacity = 16 };
+  size_t size;
+  const uchar *qryPtrs[capacity];
+  unsigned seedNums[capacity];
+  unsigned indexNums[capacity];
+  size_t begs[capacity];
+  size_t ends[capacity];
+};
+
+// Find the suffix array ranges of all the seeds in the batch.  Seeds
+// in the same index are looked up together, so that their memory
+// reads overlap.
+static void matchSeedBatch(SeedBatch &batch, const LastVolume &vol,
+			   const Dispatcher &dis) {
+  const uchar *qryPtrs[SeedBatch::capacity];
+  unsigned seedNums[SeedBatch::capacity];
+  size_t begs[SeedBatch::capacity];
+  size_t ends[SeedBatch::capacity];
+
+  for (unsigned x = 0; x < numOfIndexes; ++x) {
+    size_t n = 0;
+    for (size_t i = 0; i < batch.size; ++i) {
+      if (batch.indexNums[i] != x) continue;
+      qryPtrs[n] = batch.qryPtrs[i];
+      seedNums[n] = batch.seedNums[i];
+      ++n;
+    }
+    vol.suffixArrays[x].matchMany(begs, ends, qryPtrs, seedNums, n, dis.a,
+				  args.oneHitMultiplicity,
+				  args.minHitDepth, args.maxHitDepth);
+    n = 0;
+    for (size_t i = 0; i < batch.size; ++i) {
+      if (batch.indexNums[i] != x) continue;
+      batch.begs[i] = begs[n];
+      batch.ends[i] = ends[n];
+      ++n;
+    }
+  }
+}
+
+// Get gapless alignments from the seed hits [beg, end) at one
+// query-sequence position
 void alignGapless1(LastAligner &aligner, SegmentPairPot &gaplessAlns,
 		   const MultiSequence &qrySeqs, const SeqData &qryData,
 		   const Dispatcher &dis, DiagonalTable &dt,
 		   GaplessAlignmentCounts &counts, const SubsetSuffixArray &sa,
-		   const uchar *qryPtr, unsigned seedNum) {
+		   const uchar *qryPtr, size_t beg, size_t end) {
   const bool isOverlap = (args.globality && args.outputType == 1);
+  const int minScoreGapless = aligner.volume->minScoreGapless;
 
-  size_t beg;
-  size_t end;
-  sa.match(beg, end, qryPtr, dis.a, seedNum,
-	   args.oneHitMultiplicity, args.minHitDepth, args.maxHitDepth);
   counts.matchCount += end - beg;
 
   size_t qryPos = qryPtr - dis.b;  // coordinate in the query sequence
   size_t maxAlignments = args.maxGaplessAlignmentsPerQueryPosition;
 
+  // Unpack the reference positions a block at a time, and prefetch
+  // the reference sequence at them, so that the memory reads overlap
+  const size_t blockLen = 16;
+  size_t refPositions[blockLen];
+  size_t blockBeg = beg;
+  size_t blockEnd = beg;
+
   for (/* noop */; beg < end; ++beg) {
     if (maxAlignments == 0) break;
 
-    // it might be faster to unpack all these refPos values at once:
-    size_t refPos = sa.getPosition(beg);  // position in the reference sequence
+    if (beg == blockEnd) {
+      blockBeg = beg;
+      blockEnd = std::min(end, beg + blockLen);
+      sa.getPositions(refPositions, blockBeg, blockEnd);
+      for (size_t i = 0; i < blockEnd - blockBeg; ++i) {
+	prefetch(dis.a, refPositions[i]);
+      }
+    }
+
+    size_t refPos = refPositions[beg - blockBeg];  // position in the reference
     size_t diagonal = qryPos - refPos;
     if (dt.isCovered(diagonal, qryPos)) continue;
     ++counts.gaplessExtensionCount;
@@ -684,23 +836,56 @@ void alignGapless1(LastAligner &aligner, SegmentPairPot &gaplessAlns,
   }
 }
 
+static void addSeed(SeedBatch &batch, const uchar *qryPtr,
+		    unsigned seedNum, unsigned indexNum) {
+  batch.qryPtrs[batch.size] = qryPtr;
+  batch.seedNums[batch.size] = seedNum;
+  batch.indexNums[batch.size] = indexNum;
+  ++batch.size;
+}
+
+// Get gapless alignments from the seeds in the batch, in order, and
+// empty the batch
+static void alignSeedBatch(LastAligner &aligner,
+			   SegmentPairPot &gaplessAlns,
+			   const MultiSequence &qrySeqs,
+			   const SeqData &qryData, const Dispatcher &dis,
+			   DiagonalTable &dt, GaplessAlignmentCounts &counts,
+			   SeedBatch &batch) {
+  const LastVolume &vol = *aligner.volume;
+  matchSeedBatch(batch, vol, dis);
+  for (size_t i = 0; i < batch.size; ++i) {
+    if (counts.maxSignificantAlignments == 0) break;
+    unsigned x = batch.indexNums[i];
+    alignGapless1(aligner, gaplessAlns, qrySeqs, qryData, dis, dt, counts,
+		  vol.suffixArrays[x], batch.qryPtrs[i],
+		  batch.begs[i], batch.ends[i]);
+  }
+  batch.size = 0;
+}
+
 // Find query matches to the suffix array, and do gapless extensions
 void alignGapless(LastAligner &aligner, SegmentPairPot &gaplessAlns,
 		  const MultiSequence &qrySeqs, const SeqData &qryData,
 		  const Dispatcher &dis) {
   DiagonalTable dt;  // record already-covered positions on each diagonal
+  const LastVolume &vol = *aligner.volume;
+  const SubsetSuffixArray *suffixArrays = vol.suffixArrays;
+  const DnaWordsFinder &wordsFinder = vol.wordsFinder;
   size_t maxAlignments =
     args.maxAlignmentsPerQueryStrand ? args.maxAlignmentsPerQueryStrand : 1;
   GaplessAlignmentCounts counts = {0, 0, 0, maxAlignments};
 
   size_t loopBeg = qryData.seqBeg;
-  size_t loopEnd = seedSearchEnd(qryData.seqEnd);
+  size_t loopEnd = seedSearchEnd(vol, qryData.seqEnd);
 
   const uchar *querySeq = qryData.seq;
   const uchar *qryBeg = querySeq + loopBeg;
   const uchar *qryEnd = querySeq + loopEnd;
 
   const unsigned wordLen = wordsFinder.wordLength;
+  SeedBatch batch;
+  batch.size = 0;
 
   if (wordLen) {
     unsigned hash = 0;
@@ -711,9 +896,12 @@ void alignGapless(LastAligner &aligner, SegmentPairPot &gaplessAlns,
       if (c != dnaWordsFinderNull) {
 	unsigned w = wordsFinder.next(&hash, c);
 	if (w != dnaWordsFinderNull) {
-	  alignGapless1(aligner, gaplessAlns, qrySeqs, qryData, dis, dt,
-			counts, suffixArrays[0], qryBeg - wordLen, w);
-	  if (counts.maxSignificantAlignments == 0) break;
+	  addSeed(batch, qryBeg - wordLen, w, 0);
+	  if (batch.size == SeedBatch::capacity) {
+	    alignSeedBatch(aligner, gaplessAlns, qrySeqs, qryData, dis, dt,
+			   counts, batch);
+	    if (counts.maxSignificantAlignments == 0) break;
+	  }
 	}
       } else {
 	qryBeg = wordsFinder.init(qryBeg, qryEnd, &hash);
@@ -731,14 +919,21 @@ void alignGapless(LastAligner &aligner, SegmentPairPot &gaplessAlns,
       for (unsigned x = 0; x < numOfIndexes; ++x) {
 	if (w < 2 || minFinders[x].isMinimizer(suffixArrays[x].getSeeds()[0],
 					       qryPtr, qryEnd, w)) {
-	  alignGapless1(aligner, gaplessAlns, qrySeqs, qryData, dis, dt,
-			counts, suffixArrays[x], qryPtr, 0);
+	  addSeed(batch, qryPtr, 0, x);
+	  if (batch.size == SeedBatch::capacity) {
+	    alignSeedBatch(aligner, gaplessAlns, qrySeqs, qryData, dis, dt,
+			   counts, batch);
+	    if (counts.maxSignificantAlignments == 0) break;
+	  }
 	}
       }
       if (counts.maxSignificantAlignments == 0) break;
     }
   }
 
+  alignSeedBatch(aligner, gaplessAlns, qrySeqs, qryData, dis, dt,
+		 counts, batch);
+
   LOG2( "initial matches=" << counts.matchCount );
   LOG2( "gapless extensions=" << counts.gaplessExtensionCount );
   LOG2( "gapless alignments=" << counts.gaplessAlignmentCount );
@@ -759,7 +954,7 @@ void shrinkToLongestIdenticalRun( SegmentPair& sp, const Dispatcher& dis ){
 void alignGapped(LastAligner &aligner, AlignmentPot &gappedAlns,
 		 SegmentPairPot &gaplessAlns, const SeqData &qryData,
 		 const SubstitutionMatrices &matrices, Phase::Enum phase) {
-  Dispatcher dis(phase, qryData, matrices);
+  Dispatcher dis(phase, aligner.volume->refSeqs, qryData, matrices);
   countT gappedExtensionCount = 0, gappedAlignmentCount = 0;
 
   // Redo the gapless extensions, using gapped score parameters.
@@ -788,6 +983,8 @@ void alignGapped(LastAligner &aligner, AlignmentPot &gappedAlns,
 
   Alignment aln;
   AlignmentExtras extras;  // not used
+  // keep the extensions, so alignFinish needn't redo them
+  bool isSaveExtensions = (phase == Phase::gapped && args.outputType > 3);
 
   for (size_t i = 0; i < gaplessAlns.size(); ++i) {
     SegmentPair &sp = gaplessAlns.get(i);
@@ -800,7 +997,8 @@ void alignGapped(LastAligner &aligner, AlignmentPot &gappedAlns,
 		  dis.a, dis.b, args.globality,
 		  dis.m, scoreMatrix.maxScore, scoreMatrix.minScore,
 		  dis.r, matrices.stats.lambda(), gapCosts, dis.d,
-		  qryData.frameSize, dis.p, dis.t, dis.i, dis.j, alph, extras);
+		  qryData.frameSize, dis.p, dis.t, dis.i, dis.j, alph, extras,
+		  0, 0, isSaveExtensions);
     ++gappedExtensionCount;
 
     if (aln.score < args.minScoreGapped) continue;
@@ -837,13 +1035,16 @@ static void alignPostgapped(LastAligner &aligner, AlignmentPot &gappedAlns,
 		  dis.a, dis.b, args.globality,
 		  dis.m, scoreMatrix.maxScore, scoreMatrix.minScore,
 		  0, 0, gapCosts, dis.d,
-		  frameSize, dis.p, dis.t, dis.i, dis.j, alph, extras);
+		  frameSize, dis.p, dis.t, dis.i, dis.j, alph, extras,
+		  0, 0, args.outputType > 3);
   }
   erase_if(gappedAlns.items, AlignmentPot::isMarked);
 }
 
 // Print the gapped alignments, after optionally calculating match
-// probabilities and re-aligning using the gamma-centroid algorithm
+// probabilities and re-aligning using the gamma-centroid algorithm.
+// This re-uses the alignments' saved x-drop extensions: the scoring
+// must be the same as when they were saved.
 void alignFinish(LastAligner &aligner, const MultiSequence &qrySeqs,
 		 const SeqData &qryData, std::vector<Alignment> &alignments,
 		 const SubstitutionMatrices &matrices, const Dispatcher &dis) {
@@ -853,11 +1054,12 @@ void alignFinish(LastAligner &aligner, const MultiSequence &qrySeqs,
   if (args.isSplit && !args.splitOpts.no_split) extras.fullScore = -2;
 
   while (!alignments.empty()) {
-    const Alignment &aln = alignments.back();
+    Alignment &aln = alignments.back();
     if( args.outputType < 4 ){
       writeAlignment(aligner, qrySeqs, qryData, aln, extras);
     } else {  // calculate match probabilities:
       probAln.seed = aln.seed;
+      probAln.xdropExtensions.swap(aln.xdropExtensions);
       probAln.makeXdrop(aligner.engines, args.isGreedy, args.scoreType,
 			dis.a, dis.b, args.globality,
 			dis.m, scoreMatrix.maxScore, scoreMatrix.minScore,
@@ -885,132 +1087,209 @@ static void eraseWeakAlignments(AlignmentPot &gappedAlns,
   erase_if(gappedAlns.items, AlignmentPot::isMarked);
 }
 
-static size_t circBeg1(const Alignment &a) {  // aln start coord in sequence 1
+// aln start coord in sequence 1
+static size_t circBeg1(const MultiSequence &refSeqs, const Alignment &a) {
   size_t n = refSeqs.whichSequence(a.beg1());
   size_t s = refSeqs.seqLen(n) / 2;
   return a.beg1() - s * (a.beg1() >= refSeqs.seqBeg(n) + s);
 }
 
-static size_t circEnd1(const Alignment &a) {  // aln end coord in sequence 1
+// aln end coord in sequence 1
+static size_t circEnd1(const MultiSequence &refSeqs, const Alignment &a) {
   size_t n = refSeqs.whichSequence(a.end1());
   size_t s = refSeqs.seqLen(n) / 2;
   return a.end1() - s * (a.end1() > refSeqs.seqBeg(n) + s);
 }
 
-static bool lessBegCircular(const Alignment &x, const Alignment &y) {
-  if (x.beg2() != y.beg2()) return x.beg2() < y.beg2();
-  size_t xb1 = circBeg1(x);
-  size_t yb1 = circBeg1(y);
-  if (xb1 != yb1) return xb1 < yb1;
-  if (x.score != y.score) return x.score > y.score;
-  return x.beg1() < y.beg1();
-}
+struct LessBegCircular {
+  const MultiSequence &refSeqs;
+  bool operator()(const Alignment &x, const Alignment &y) const {
+    if (x.beg2() != y.beg2()) return x.beg2() < y.beg2();
+    size_t xb1 = circBeg1(refSeqs, x);
+    size_t yb1 = circBeg1(refSeqs, y);
+    if (xb1 != yb1) return xb1 < yb1;
+    if (x.score != y.score) return x.score > y.score;
+    return x.beg1() < y.beg1();
+  }
+};
 
-static bool lessEndCircular(const Alignment &x, const Alignment &y) {
-  if (x.end2() != y.end2()) return x.end2() < y.end2();
-  size_t xe1 = circEnd1(x);
-  size_t ye1 = circEnd1(y);
-  if (xe1 != ye1) return xe1 < ye1;
-  if (x.score != y.score) return x.score > y.score;
-  return x.end1() < y.end1();
-}
+struct LessEndCircular {
+  const MultiSequence &refSeqs;
+  bool operator()(const Alignment &x, const Alignment &y) const {
+    if (x.end2() != y.end2()) return x.end2() < y.end2();
+    size_t xe1 = circEnd1(refSeqs, x);
+    size_t ye1 = circEnd1(refSeqs, y);
+    if (xe1 != ye1) return xe1 < ye1;
+    if (x.score != y.score) return x.score > y.score;
+    return x.end1() < y.end1();
+  }
+};
 
-static void omitCircularSeqRedundancy(std::vector<Alignment> &a) {
+static void omitCircularSeqRedundancy(const MultiSequence &refSeqs,
+				      std::vector<Alignment> &a) {
   size_t s = a.size();
-  sort(a.begin(), a.end(), lessBegCircular);
+  LessBegCircular lessBeg = {refSeqs};
+  sort(a.begin(), a.end(), lessBeg);
   for (size_t i = 1; i < s; ++i) {
-    if (a[i].beg2() == a[i-1].beg2() && circBeg1(a[i]) == circBeg1(a[i-1])) {
+    if (a[i].beg2() == a[i-1].beg2() &&
+	circBeg1(refSeqs, a[i]) == circBeg1(refSeqs, a[i-1])) {
       AlignmentPot::mark(a[i]);  // 2 alns have same start coords in both seqs
     }
   }
-  sort(a.begin(), a.end(), lessEndCircular);
+  LessEndCircular lessEnd = {refSeqs};
+  sort(a.begin(), a.end(), lessEnd);
   for (size_t i = 1; i < s; ++i) {
-    if (a[i].end2() == a[i-1].end2() && circEnd1(a[i]) == circEnd1(a[i-1])) {
+    if (a[i].end2() == a[i-1].end2() &&
+	circEnd1(refSeqs, a[i]) == circEnd1(refSeqs, a[i-1])) {
       AlignmentPot::mark(a[i]);  // 2 alns have same end coords in both seqs
     }
   }
   erase_if(a, AlignmentPot::isMarked);
 }
 
-static bool lessForCulling(const AlignmentText &x, const AlignmentText &y) {
+static const AlignmentText &cullingKey(const AlignmentText &a) { return a; }
+
+static const AlignmentText &cullingKey(const PendingAlignment &a) {
+  return a.key;
+}
+
+template<typename T>
+static bool lessForCulling(const T &a, const T &b) {
+  const AlignmentText &x = cullingKey(a);
+  const AlignmentText &y = cullingKey(b);
   if (x.strandNum != y.strandNum) return x.strandNum < y.strandNum;
   if (x.queryBeg  != y.queryBeg ) return x.queryBeg  < y.queryBeg;
   else                            return x.score     > y.score;
 }
 
-// Remove any alignment whose query range overlaps an alignment with
-// higher score (and on the same strand):
-static void cullOverlappingAlignments(std::vector<AlignmentText> &textAlns,
-				      size_t start) {
-  size_t end = textAlns.size();
+// Find alignments whose query range overlaps an alignment with higher
+// score (and on the same strand).  Move the others, in order, to the
+// start of [start, end), and return where they end.
+template<typename T>
+static size_t cullOverlapping(std::vector<T> &alns, size_t start) {
+  size_t end = alns.size();
+  std::vector<char> isCulled(end - start);
+  char *culled = isCulled.data() - start;
   size_t i = start;
   for (size_t j = start; j < end; ++j) {
-    AlignmentText &x = textAlns[j];
+    const AlignmentText &x = cullingKey(alns[j]);
     for (size_t k = j + 1; k < end; ++k) {
-      AlignmentText &y = textAlns[k];
+      const AlignmentText &y = cullingKey(alns[k]);
       if (y.strandNum > x.strandNum || y.queryBeg >= x.queryEnd) break;
-      if (x.score > y.score) {
-	delete[] y.text;
-	y.text = 0;
-      }
-      if (y.score > x.score) {
-	delete[] x.text;
-	x.text = 0;
-      }
+      if (x.score > y.score) culled[k] = 1;
+      if (y.score > x.score) culled[j] = 1;
     }
-    if (x.text) {
-      textAlns[i] = x;
+    if (!culled[j]) {
+      std::swap(alns[i], alns[j]);
+      std::swap(culled[i], culled[j]);
       ++i;
     }
   }
-  textAlns.resize(i);
+  return i;
 }
 
-// Remove any alignment whose query range lies in LIMIT or more other
-// alignments with higher score (and on the same strand):
-static void cullFinalAlignments(std::vector<AlignmentText> &textAlns,
-				size_t start, size_t limit) {
-  if (limit + 1 == 0) return;
-  sort(textAlns.begin() + start, textAlns.end(), lessForCulling);
-  if (limit == 0) return cullOverlappingAlignments(textAlns, start);
+// Find alignments whose query range lies in LIMIT or more other
+// alignments with higher score (and on the same strand).  Move the
+// others, in order, to the start of [start, end), and return where
+// they end.
+template<typename T>
+static size_t cullAlignments(std::vector<T> &alns,
+			     size_t start, size_t limit) {
+  if (limit + 1 == 0) return alns.size();
+  sort(alns.begin() + start, alns.end(), lessForCulling<T>);
+  if (limit == 0) return cullOverlapping(alns, start);
   std::vector<size_t> stash;  // alignments that might dominate subsequent ones
   size_t i = start;  // number of kept alignments so far
-  for (size_t j = start; j < textAlns.size(); ++j) {
-    AlignmentText &x = textAlns[j];
+  for (size_t j = start; j < alns.size(); ++j) {
+    const AlignmentText &x = cullingKey(alns[j]);
     size_t numOfDominators = 0;  // number of alignments that dominate x
     size_t a = 0;  // number of kept stash-items so far
     for (size_t b = 0; b < stash.size(); ++b) {
       size_t k = stash[b];
-      AlignmentText &y = textAlns[k];
+      const AlignmentText &y = cullingKey(alns[k]);
       if (y.strandNum < x.strandNum) break;  // drop the stash
       if (y.queryEnd <= x.queryBeg) continue;  // drop this stash-item
       stash[a++] = k;  // keep this stash-item
       if (y.queryEnd >= x.queryEnd && y.score > x.score) ++numOfDominators;
     }
     stash.resize(a);
-    if (numOfDominators >= limit) {
-      delete[] x.text;
-    } else {
+    if (numOfDominators < limit) {
       stash.push_back(i);
-      textAlns[i++] = x;  // keep this alignment
+      std::swap(alns[i++], alns[j]);  // keep this alignment
     }
   }
-  textAlns.resize(i);
+  return i;
 }
 
-static void printAlignments(const std::vector<AlignmentText> &textAlns) {
-  for (size_t i = 0; i < textAlns.size(); ++i) {
-    std::cout << textAlns[i].text;
+// Remove any alignment whose query range lies in LIMIT or more other
+// alignments with higher score (and on the same strand).  As a
+// special case, if LIMIT is 0, remove any alignment whose query range
+// overlaps an alignment with higher score (and on the same strand).
+// The removed alignments' text stays in the arena until it's reset.
+static void cullFinalAlignments(std::vector<AlignmentText> &textAlns,
+				size_t start, size_t limit) {
+  textAlns.resize(cullAlignments(textAlns, start, limit));
+}
+
+// Remove pending alignments that will surely be culled, because they
+// lie in LIMIT or more alignments from previous volumes (which are
+// sorted for culling) with higher score.  This is exact, because any
+// of those that get culled themselves are in LIMIT or more others,
+// which also contain the pending alignment.
+static void cullByOldAlignments(std::vector<PendingAlignment> &pendingAlns,
+				const AlignmentText *oldBeg,
+				const AlignmentText *oldEnd, size_t limit) {
+  const AlignmentText &k = pendingAlns[0].key;  // all on the same strand
+  AlignmentText strandBeg = k;
+  strandBeg.queryBeg = 0;
+  strandBeg.score = HUGE_VAL;
+  oldBeg = std::lower_bound(oldBeg, oldEnd, strandBeg,
+			    lessForCulling<AlignmentText>);
+  size_t i = 0;
+  for (size_t j = 0; j < pendingAlns.size(); ++j) {
+    const AlignmentText &x = pendingAlns[j].key;
+    size_t numOfDominators = 0;
+    for (const AlignmentText *y = oldBeg; y < oldEnd; ++y) {
+      if (y->strandNum != x.strandNum || y->queryBeg > x.queryBeg) break;
+      if (y->queryEnd >= x.queryEnd && y->score > x.score) ++numOfDominators;
+    }
+    if (numOfDominators < limit) std::swap(pendingAlns[i++], pendingAlns[j]);
   }
+  pendingAlns.resize(i);
 }
 
-static void freeAlignmentTexts(AlignmentText *textAlns, size_t textAlnCount) {
-  for (size_t i = 0; i < textAlnCount; ++i) delete[] textAlns[i].text;
+// Cull the pending alignments, and write the rest as text
+static void writePendingAlignments(LastAligner &aligner,
+				   const MultiSequence &qrySeqs,
+				   const SeqData &qryData,
+				   size_t cullingLimit) {
+  std::vector<PendingAlignment> &pendingAlns = aligner.pendingAlns;
+  pendingAlns.resize(cullAlignments(pendingAlns, 0, cullingLimit));
+  size_t finalLimit = args.cullingLimitForFinalAlignments;
+  if (aligner.numOfOldAlns && !pendingAlns.empty() &&
+      finalLimit > 0 && finalLimit + 1 > 0) {
+    const AlignmentText *old = aligner.textAlns.data();
+    cullByOldAlignments(pendingAlns, old, old + aligner.numOfOldAlns,
+			finalLimit);
+  }
+  aligner.isCullBeforeWriting = false;
+  for (size_t i = 0; i < pendingAlns.size(); ++i) {
+    const PendingAlignment &p = pendingAlns[i];
+    writeAlignment(aligner, qrySeqs, qryData, p.aln, p.extras);
+  }
+  pendingAlns.clear();
 }
 
-static void clearAlignments(std::vector<AlignmentText> &textAlns) {
-  freeAlignmentTexts(textAlns.data(), textAlns.size());
+static void printAlignments(const std::vector<AlignmentText> &textAlns) {
+  for (size_t i = 0; i < textAlns.size(); ++i) {
+    printAlignment(textAlns[i].text);
+  }
+}
+
+static void clearAlignments(std::vector<AlignmentText> &textAlns,
+			    mcf::Arena &textArena) {
   textAlns.clear();
+  textArena.reset();
 }
 
 void makeQualityPssm(const SeqData &qryData,
@@ -1052,7 +1331,8 @@ void scan(LastAligner &aligner, const MultiSequence &qrySeqs,
   const int maskMode = args.maskLowercase;
   makeQualityPssm(qryData, matrices, maskMode > 0);
 
-  Dispatcher dis0(Phase::gapless, qryData, matrices);
+  const MultiSequence &refSeqs = aligner.volume->refSeqs;
+  Dispatcher dis0(Phase::gapless, refSeqs, qryData, matrices);
   size_t qryLen = qryData.padLen;
   AlignmentPot gappedAlns;
   Centroid &centroid = aligner.engines.centroid;
@@ -1084,7 +1364,7 @@ void scan(LastAligner &aligner, const MultiSequence &qrySeqs,
 
   if (gappedAlns.size() == 0) return;
 
-  Dispatcher dis3(Phase::postgapped, qryData, matrices);
+  Dispatcher dis3(Phase::postgapped, refSeqs, qryData, matrices);
 
   if (maskMode == 2 && args.scoreType != 0) {
     unmaskLowercase(qryData, matrices);
@@ -1102,7 +1382,9 @@ void scan(LastAligner &aligner, const MultiSequence &qrySeqs,
 
   if( args.outputType > 2 ){  // we want non-redundant alignments
     gappedAlns.eraseSuboptimal();
-    if (refSeqs.isCircular(0)) omitCircularSeqRedundancy(gappedAlns.items);
+    if (refSeqs.isCircular(0)) {
+      omitCircularSeqRedundancy(refSeqs, gappedAlns.items);
+    }
     LOG2( "nonredundant gapped alignments=" << gappedAlns.size() );
   }
 
@@ -1123,9 +1405,11 @@ void scan(LastAligner &aligner, const MultiSequence &qrySeqs,
   alignFinish(aligner, qrySeqs, qryData, gappedAlns.items, matrices, dis3);
 }
 
+// A very long query (e.g. an ultra-long read) might hold up the other
+// threads, so let it use as many threads as we have for masking
 static void tantanMaskOneQuery(const SeqData &qryData) {
   tantanMasker.mask(qryData.seq + qryData.seqBeg, qryData.seq + qryData.seqEnd,
-		    queryAlph.numbersToLowercase);
+		    queryAlph.numbersToLowercase, aligners.size());
 }
 
 static void tantanMaskTranslatedQuery(const SeqData &qryData) {
@@ -1138,7 +1422,7 @@ static void tantanMaskTranslatedQuery(const SeqData &qryData) {
     size_t aaLen = dnaLen-- / 3;
     size_t aaEnd = aaBeg + aaLen;
     tantanMasker.mask(qryData.seq + aaBeg, qryData.seq + aaEnd,
-		      alph.numbersToLowercase);
+		      alph.numbersToLowercase, aligners.size());
   }
 }
 
@@ -1174,11 +1458,14 @@ void translateAndScan(LastAligner &aligner, MultiSequence &qrySeqs,
   }
 
   if (args.outputType == 0) {
-    countMatches(aligner.matchCounts[chunkQryNum], qryData);
+    countMatches(aligner.matchCounts[chunkQryNum], *aligner.volume, qryData);
   } else {
-    size_t oldNumOfAlns = aligner.textAlns.size();
+    // If we'll cull, keep compact records, and make text for survivors only
+    aligner.isCullBeforeWriting = (finalCullingLimit + 1 > 0);
     scan(aligner, qrySeqs, qryData, matrices);
-    cullFinalAlignments(aligner.textAlns, oldNumOfAlns, finalCullingLimit);
+    if (aligner.isCullBeforeWriting) {
+      writePendingAlignments(aligner, qrySeqs, qryData, finalCullingLimit);
+    }
   }
 
   qryData.seq = qrySeqs.seqWriter() + qrySeqs.padBeg(qryData.seqNum);
@@ -1195,11 +1482,19 @@ static bool lessForSplitting(const AlignmentText &x, const AlignmentText &y) {
 
 static void setupSplitAlignments(LastAligner &aligner, AlignmentText *textAlns,
 				 size_t textAlnCount, bool isQryQual) {
+  LastSplitter &splitter = aligner.splitter;
+  splitter.reserve(textAlnCount);
+
+  if (isSplitWithoutMaf(aligner.volume->refSeqs)) {
+    for (size_t i = 0; i < textAlnCount; ++i) {
+      splitter.addAlignment(textAlns[i].text);
+    }
+    return;
+  }
+
   unsigned linesPerMaf =
     3 + isQryQual + (args.outputType > 3) + (args.outputType > 6);
 
-  LastSplitter &splitter = aligner.splitter;
-  splitter.reserve(textAlnCount);
   aligner.alignmentTextLines.resize((linesPerMaf + 1) * textAlnCount);
 
   char **beg = aligner.alignmentTextLines.data();
@@ -1221,7 +1516,7 @@ static void splitAlignments(LastAligner &aligner, bool isQryQual) {
   std::vector<AlignmentText> &textAlns = aligner.textAlns;
   setupSplitAlignments(aligner, textAlns.data(), textAlns.size(), isQryQual);
   aligner.splitter.split(args.splitOpts, splitParams, false);
-  clearAlignments(textAlns);
+  clearAlignments(textAlns, aligner.textArena);
 }
 
 static void splitOneQuery(LastAligner &aligner, bool isQryQual) {
@@ -1239,12 +1534,11 @@ static void splitOneQuery(LastAligner &aligner, bool isQryQual) {
     if (j == textAlnCount || textAlns[j].queryBeg >= maxEnd) {
       setupSplitAlignments(aligner, textAlns + i, j - i, isQryQual);
       aligner.splitter.splitOneQuery(args.splitOpts, splitParams);
-      freeAlignmentTexts(textAlns + i, j - i);
       i = j;
     }
   }
 
-  aligner.textAlns.clear();
+  clearAlignments(aligner.textAlns, aligner.textArena);
 }
 
 static void alignOneQuery(LastAligner &aligner, MultiSequence &qrySeqs,
@@ -1308,54 +1602,105 @@ static void alignOneQuery(LastAligner &aligner, MultiSequence &qrySeqs,
   }
 }
 
-static size_t alignSomeQueries(size_t chunkNum, unsigned volume) {
-  size_t numOfChunks = aligners.size();
-  LastAligner &aligner = aligners[chunkNum];
+// Align the query sequences in one chunk to one database volume.  The
+// chunk's results from previous volumes are kept in the chunk, so any
+// thread can do any chunk.
+static void alignQueryChunk(LastAligner &aligner, size_t chunkNum,
+			    unsigned volume) {
+  size_t numOfChunks = queryChunks.size();
+  QueryChunk &chunk = queryChunks[chunkNum];
   size_t beg = firstSequenceInChunk(qrySeqsGlobal, numOfChunks, chunkNum);
   size_t end = firstSequenceInChunk(qrySeqsGlobal, numOfChunks, chunkNum + 1);
   bool isMultiVolume = (numOfVolumes > 1);
   bool isFirstVolume = (volume == 0);
+  bool isLastVolume = (volume + 1 == numOfVolumes);
   size_t finalCullingLimit = args.cullingLimitForFinalAlignments ?
     args.cullingLimitForFinalAlignments : isMultiVolume;
+  size_t cullingLimit = args.cullingLimitForFinalAlignments;
+  bool isCullEachVolume = isMultiVolume && cullingLimit > 0 &&
+    cullingLimit + 1 > 0 && args.outputType > 0;
+  std::vector<AlignmentText> &textAlns = aligner.textAlns;
+  textAlns.swap(chunk.textAlns);
+  aligner.textArena.swap(chunk.textArena);
+  aligner.matchCounts.swap(chunk.matchCounts);
   if (args.outputType == 0 && isFirstVolume) {
     aligner.matchCounts.resize(end - beg);
   }
+  if (isCullEachVolume) aligner.numOfOldAlns = textAlns.size();
   for (size_t i = beg; i < end; ++i) {
     alignOneQuery(aligner, qrySeqsGlobal, i, i - beg,
 		  finalCullingLimit, isFirstVolume);
   }
-  if (isMultiVolume && volume + 1 == numOfVolumes) {
-    std::vector<AlignmentText> &textAlns = aligner.textAlns;
+  aligner.numOfOldAlns = 0;
+  if (isCullEachVolume && !isLastVolume) {
+    // this leaves them sorted for culling the next volume's alignments
+    cullFinalAlignments(textAlns, 0, cullingLimit);
+  }
+  if (isMultiVolume && isLastVolume) {
     cullFinalAlignments(textAlns, 0, args.cullingLimitForFinalAlignments);
     if (args.isSplit) splitAlignments(aligner, qrySeqsGlobal.qualsPerLetter());
     sort(textAlns.begin(), textAlns.end());
   }
-  return beg;
+  if (isLastVolume) aligner.splitter.moveOutputTo(chunk.splitOutput);
+  textAlns.swap(chunk.textAlns);
+  aligner.textArena.swap(chunk.textArena);
+  aligner.matchCounts.swap(chunk.matchCounts);
+}
+
+// Mark the chunk as done, and print the results of all done chunks
+// that are next in line, so the output order doesn't depend on which
+// thread finishes first
+static void printDoneChunks(size_t chunkNum) {
+  size_t numOfChunks = queryChunks.size();
+  std::lock_guard<std::mutex> lockGuard(outputMutex);
+  queryChunks[chunkNum].isDone = true;
+  while (nextChunkToPrint < numOfChunks &&
+	 queryChunks[nextChunkToPrint].isDone) {
+    QueryChunk &chunk = queryChunks[nextChunkToPrint];
+    size_t firstSequence =
+      firstSequenceInChunk(qrySeqsGlobal, numOfChunks, nextChunkToPrint);
+    writeCounts(chunk.matchCounts, qrySeqsGlobal, firstSequence, std::cout);
+    chunk.matchCounts.clear();
+    printAlignments(chunk.textAlns);
+    clearAlignments(chunk.textAlns, chunk.textArena);
+    std::cout.write(chunk.splitOutput.data(), chunk.splitOutput.size());
+    std::vector<char>().swap(chunk.splitOutput);
+    ++nextChunkToPrint;
+  }
+}
+
+static LastVolume &volumeSlot(unsigned volumeNumber) {
+  return volumes[volumeNumber % volumes.size()];
+}
+
+// Take chunks one at a time, until none are left, and align them to
+// volumes volBeg to volEnd-1
+static void alignQueryChunks(unsigned threadNum,
+			     unsigned volBeg, unsigned volEnd) {
+  LastAligner &aligner = aligners[threadNum];
+  for (;;) {
+    size_t chunkNum = nextQueryChunk++;
+    if (chunkNum >= queryChunks.size()) break;
+    for (unsigned v = volBeg; v < volEnd; ++v) {
+      aligner.volume = &volumeSlot(v);
+      alignQueryChunk(aligner, chunkNum, v);
+    }
+    if (volEnd == numOfVolumes) printDoneChunks(chunkNum);
+  }
 }
 
-static void scanOneVolume(unsigned volume, unsigned numOfThreadsLeft) {
-  size_t firstSequence = 0;
+static void scanVolumes(unsigned volBeg, unsigned volEnd,
+			unsigned numOfThreadsLeft) {
   if (numOfThreadsLeft > 1) {
 #ifdef HAS_CXX_THREADS
-    std::thread t(scanOneVolume, volume, numOfThreadsLeft - 1);
+    std::thread t(scanVolumes, volBeg, volEnd, numOfThreadsLeft - 1);
     // Exceptions from threads are not handled nicely, but I don't
     // think it matters much.
-    firstSequence = alignSomeQueries(numOfThreadsLeft - 1, volume);
+    alignQueryChunks(numOfThreadsLeft - 1, volBeg, volEnd);
     t.join();
 #endif
   } else {
-    firstSequence = alignSomeQueries(0, volume);
-  }
-  if (volume + 1 == numOfVolumes) {
-    LastAligner &aligner = aligners[numOfThreadsLeft - 1];
-    writeCounts(aligner.matchCounts, qrySeqsGlobal, firstSequence);
-    aligner.matchCounts.clear();
-    printAlignments(aligner.textAlns);
-    clearAlignments(aligner.textAlns);
-    if (!aligner.splitter.isOutputEmpty()) {
-      aligner.splitter.printOutput();
-      aligner.splitter.clearOutput();
-    }
+    alignQueryChunks(0, volBeg, volEnd);
   }
 }
 
@@ -1419,6 +1764,19 @@ static bool readSequenceData(MultiSequence &qrySeqs) {
   return false;
 }
 
+static void alignQueries(LastAligner &aligner, MultiSequence &qrySeqs) {
+  if (!qrySeqs.isFinished()) throwSeqTooBig();
+  encodeSequences(qrySeqs, args.inputFormat, queryAlph,
+		  args.isKeepLowercase, 0);
+  if (args.outputType == 0) {
+    aligner.matchCounts.resize(qrySeqs.finishedSequences());
+  }
+  for (size_t i = 0; i < qrySeqs.finishedSequences(); ++i) {
+    alignOneQuery(aligner, qrySeqs, i, i,
+		  args.cullingLimitForFinalAlignments, true);
+  }
+}
+
 static void runOneThread(unsigned threadNum) {
   LastAligner &aligner = aligners[threadNum];
   LastSplitter &splitter = aligner.splitter;
@@ -1428,40 +1786,172 @@ static void runOneThread(unsigned threadNum) {
   initSequences(qrySeqs, queryAlph, args.isTranslated(), false);
 
   while (readSequenceData(qrySeqs)) {
-    if (!qrySeqs.isFinished()) throwSeqTooBig();
-    encodeSequences(qrySeqs, args.inputFormat, queryAlph,
-		    args.isKeepLowercase, 0);
-    if (args.outputType == 0) matchCounts.resize(qrySeqs.finishedSequences());
-    for (size_t i = 0; i < qrySeqs.finishedSequences(); ++i) {
-      alignOneQuery(aligner, qrySeqs, i, i,
-		    args.cullingLimitForFinalAlignments, true);
-    }
+    alignQueries(aligner, qrySeqs);
     if (!splitter.isOutputEmpty()) {
-      {
-	std::lock_guard<std::mutex> lockGuard(outputMutex);
-	splitter.printOutput();
-      }
+      splitter.printOutput();
       splitter.clearOutput();
     } else if (!textAlns.empty()) {
-      {
-	std::lock_guard<std::mutex> lockGuard(outputMutex);
-	printAlignments(textAlns);
-      }
-      clearAlignments(textAlns);
+      printAlignments(textAlns);
+      clearAlignments(textAlns, aligner.textArena);
     } else if (!matchCounts.empty()) {
-      {
-	std::lock_guard<std::mutex> lockGuard(outputMutex);
-	writeCounts(matchCounts, qrySeqs, 0);
-      }
+      writeCounts(matchCounts, qrySeqs, 0, std::cout);
       matchCounts.clear();
     }
     qrySeqs.reinitForAppending();
   }
 }
 
-static void runOneThreadSafely(unsigned threadNum) {
+// Read query batches, until the input ends
+static void readQueryBatches(unsigned) {
+  QueryPipeline &p = queryPipeline;
+  for (;;) {
+    size_t b;
+    {
+      std::unique_lock<std::mutex> lock(p.mutex);
+      while (p.freeBatches.empty()) p.isFree.wait(lock);
+      b = p.freeBatches.back();
+      p.freeBatches.pop_back();
+    }
+    QueryBatch &batch = p.batches[b];
+    bool isOk = readSequenceData(batch.qrySeqs);
+    std::lock_guard<std::mutex> lockGuard(p.mutex);
+    if (!isOk) {
+      p.freeBatches.push_back(b);
+      p.isEndOfInput = true;
+      p.isRead.notify_all();
+      p.isAligned.notify_one();
+      return;
+    }
+    batch.serialNum = p.numOfReadBatches++;
+    p.readBatches.push_back(b);
+    p.isRead.notify_one();
+  }
+}
+
+// Take read batches and align them, until there are no more
+static void alignQueryBatches(unsigned threadNum) {
+  QueryPipeline &p = queryPipeline;
+  LastAligner &aligner = aligners[threadNum];
+  for (;;) {
+    size_t b;
+    {
+      std::unique_lock<std::mutex> lock(p.mutex);
+      while (p.readBatches.empty() && !p.isEndOfInput) p.isRead.wait(lock);
+      if (p.readBatches.empty()) return;
+      b = p.readBatches.front();
+      p.readBatches.pop_front();
+    }
+    QueryBatch &batch = p.batches[b];
+    alignQueries(aligner, batch.qrySeqs);
+    // the writer thread resets the batch's arena, so the aligner gets
+    // back an empty one
+    batch.textAlns.swap(aligner.textAlns);
+    batch.textArena.swap(aligner.textArena);
+    aligner.splitter.moveOutputTo(batch.text);
+    if (!aligner.matchCounts.empty()) {
+      std::ostringstream out;
+      writeCounts(aligner.matchCounts, batch.qrySeqs, 0, out);
+      const std::string &s = out.str();
+      batch.text.insert(batch.text.end(), s.begin(), s.end());
+      aligner.matchCounts.clear();
+    }
+    std::lock_guard<std::mutex> lockGuard(p.mutex);
+    p.alignedBatches.push_back(b);
+    p.isAligned.notify_one();
+  }
+}
+
+// Write the buffers to standard output, with few system calls
+static void writeBuffers(iovec *buffers, size_t numOfBuffers) {
+  const size_t maxBuffersPerCall = 1024;  // IOV_MAX is at least this
+  while (numOfBuffers > 0) {
+    int n = std::min(numOfBuffers, maxBuffersPerCall);
+    ssize_t size = writev(STDOUT_FILENO, buffers, n);
+    if (size < 0) {
+      if (errno == EINTR) continue;
+      ERR("write error");
+    }
+    size_t s = size;
+    while (numOfBuffers > 0 && s >= buffers->iov_len) {
+      s -= buffers->iov_len;
+      ++buffers;
+      --numOfBuffers;
+    }
+    if (s > 0) {
+      buffers->iov_base = (char *)buffers->iov_base + s;
+      buffers->iov_len -= s;
+    }
+  }
+}
+
+static void addBuffer(std::vector<iovec> &buffers, const char *beg,
+		      size_t size) {
+  iovec v;
+  v.iov_base = const_cast<char *>(beg);
+  v.iov_len = size;
+  if (size) buffers.push_back(v);
+}
+
+// Write aligned batches in the order they were read, until all are
+// written.  Whenever several consecutive batches are ready, their
+// alignment texts are written together, without copying them.
+static void writeQueryBatches(unsigned) {
+  QueryPipeline &p = queryPipeline;
+  std::vector<size_t> batchesToWrite;
+  std::vector<iovec> buffers;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(p.mutex);
+      for (;;) {
+	std::vector<size_t> &v = p.alignedBatches;
+	countT nextSerialNum = p.numOfWrittenBatches + batchesToWrite.size();
+	size_t i = 0;
+	while (i < v.size() && p.batches[v[i]].serialNum != nextSerialNum) ++i;
+	if (i < v.size()) {
+	  batchesToWrite.push_back(v[i]);
+	  v[i] = v.back();
+	  v.pop_back();
+	} else if (!batchesToWrite.empty()) {
+	  break;
+	} else if (p.isEndOfInput &&
+		   p.numOfWrittenBatches == p.numOfReadBatches) {
+	  return;
+	} else {
+	  p.isAligned.wait(lock);
+	}
+      }
+    }
+
+    for (size_t i = 0; i < batchesToWrite.size(); ++i) {
+      QueryBatch &batch = p.batches[batchesToWrite[i]];
+      for (size_t j = 0; j < batch.textAlns.size(); ++j) {
+	const char *t = batch.textAlns[j].text;
+	addBuffer(buffers, t, alignmentTextSize(t));
+      }
+      addBuffer(buffers, batch.text.data(), batch.text.size());
+    }
+    writeBuffers(buffers.data(), buffers.size());
+    buffers.clear();
+
+    for (size_t i = 0; i < batchesToWrite.size(); ++i) {
+      QueryBatch &batch = p.batches[batchesToWrite[i]];
+      clearAlignments(batch.textAlns, batch.textArena);
+      batch.text.clear();
+      batch.qrySeqs.reinitForAppending();
+    }
+    std::lock_guard<std::mutex> lockGuard(p.mutex);
+    for (size_t i = 0; i < batchesToWrite.size(); ++i) {
+      p.freeBatches.push_back(batchesToWrite[i]);
+    }
+    p.numOfWrittenBatches += batchesToWrite.size();
+    p.isFree.notify_one();
+    batchesToWrite.clear();
+  }
+}
+
+static void runSafely(void (*func)(unsigned), unsigned threadNum) {
   try {
-    runOneThread(threadNum);
+    func(threadNum);
   } catch (const std::bad_alloc &e) {
     std::cerr << args.programName << ": out of memory\n";
     raise(SIGTERM);
@@ -1471,22 +1961,49 @@ static void runOneThreadSafely(unsigned threadNum) {
   }
 }
 
-static void runThreads(unsigned numOfThreads) {
+static void runAlignerThreads(unsigned numOfThreads) {
   if (numOfThreads > 1) {
 #ifdef HAS_CXX_THREADS
-    std::thread t(runThreads, numOfThreads - 1);
-    runOneThreadSafely(numOfThreads - 1);
+    std::thread t(runAlignerThreads, numOfThreads - 1);
+    runSafely(alignQueryBatches, numOfThreads - 1);
     t.join();
 #endif
   } else {
-    runOneThreadSafely(0);
+    runSafely(alignQueryBatches, 0);
   }
 }
 
-void readIndex(const std::string &baseName, size_t seqCount, int bitsPerBase,
-	       int bitsPerInt, bool isCaseSensitive) {
+// With 1 thread, read, align, and write each batch in turn.  With more
+// threads, parse the input in a reader thread, and write the output in
+// a writer thread, in the same order as the input.
+static void runThreads(unsigned numOfThreads) {
+  if (numOfThreads < 2) return runSafely(runOneThread, 0);
+#ifdef HAS_CXX_THREADS
+  const size_t batchesPerThread = 4;
+  QueryPipeline &p = queryPipeline;
+  std::vector<QueryBatch>(numOfThreads * batchesPerThread).swap(p.batches);
+  for (size_t i = 0; i < p.batches.size(); ++i) {
+    initSequences(p.batches[i].qrySeqs, queryAlph, args.isTranslated(), false);
+    p.freeBatches.push_back(i);
+  }
+  p.numOfReadBatches = 0;
+  p.numOfWrittenBatches = 0;
+  p.isEndOfInput = false;
+
+  if (!flush(std::cout)) ERR("write error");
+  std::thread reader(runSafely, readQueryBatches, 0);
+  std::thread writer(runSafely, writeQueryBatches, 0);
+  runAlignerThreads(numOfThreads);
+  reader.join();
+  writer.join();
+#endif
+}
+
+void readIndex(LastVolume &vol, const std::string &baseName, size_t seqCount,
+	       int bitsPerBase, int bitsPerInt, bool isCaseSensitive) {
+  SubsetSuffixArray *suffixArrays = vol.suffixArrays;
   LOG( "reading " << baseName << "..." );
-  refSeqs.fromFiles(baseName, seqCount,
+  vol.refSeqs.fromFiles(baseName, seqCount,
 		    referenceFormat != sequenceFormat::fasta,
 		    bitsPerBase == 4, bitsPerInt == 32);
   for( unsigned x = 0; x < numOfIndexes; ++x ){
@@ -1502,7 +2019,7 @@ void readIndex(const std::string &baseName, size_t seqCount, int bitsPerBase,
 
   const std::vector<CyclicSubsetSeed> &seeds = suffixArrays[0].getSeeds();
   assert(!seeds.empty());  // xxx what if numOfIndexes==0 ?
-  makeWordsFinder(wordsFinder, &seeds[0], seeds.size(), alph.encode,
+  makeWordsFinder(vol.wordsFinder, &seeds[0], seeds.size(), alph.encode,
 		  isCaseSensitive);
 
   if (scoreMatrix.isCodonCols()) {
@@ -1544,14 +2061,47 @@ int calcMinScoreGapless(double numLettersInReference) {
 }
 
 // Read one database volume
-void readVolume(unsigned volumeNumber, int bitsPerBase, int bitsPerInt,
-		bool isCaseSensitive) {
+void readVolume(LastVolume &vol, unsigned volumeNumber,
+		int bitsPerBase, int bitsPerInt, bool isCaseSensitive) {
   std::string baseName = args.lastdbName + stringify(volumeNumber);
   size_t seqCount = -1;
   size_t seqLen = -1;
   readInnerPrj(baseName + ".prj", seqCount, seqLen);
-  minScoreGapless = calcMinScoreGapless(seqLen);
-  readIndex(baseName, seqCount, bitsPerBase, bitsPerInt, isCaseSensitive);
+  vol.volumeNumber = -1;
+  vol.minScoreGapless = calcMinScoreGapless(seqLen);
+  readIndex(vol, baseName, seqCount, bitsPerBase, bitsPerInt, isCaseSensitive);
+  vol.volumeNumber = volumeNumber;
+}
+
+// Make sure the volume is in memory
+static void loadVolume(unsigned volumeNumber, int bitsPerBase, int bitsPerInt,
+		       bool isCaseSensitive) {
+  LastVolume &vol = volumeSlot(volumeNumber);
+  if (vol.volumeNumber != volumeNumber) {
+    readVolume(vol, volumeNumber, bitsPerBase, bitsPerInt, isCaseSensitive);
+  }
+}
+
+// Read a volume in the background, while other threads align queries
+static void preloadVolume(unsigned volumeNumber, int bitsPerBase,
+			  int bitsPerInt, bool isCaseSensitive) {
+  try {
+    loadVolume(volumeNumber, bitsPerBase, bitsPerInt, isCaseSensitive);
+  } catch (const std::bad_alloc &e) {
+    std::cerr << args.programName << ": out of memory\n";
+    raise(SIGTERM);
+  } catch (const std::exception &e) {
+    std::cerr << args.programName << ": " << e.what() << '\n';
+    raise(SIGTERM);
+  }
+}
+
+static void resetQueryChunks() {
+  for (size_t j = 0; j < queryChunks.size(); ++j) {
+    queryChunks[j].isDone = false;
+  }
+  nextQueryChunk = 0;
+  nextChunkToPrint = 0;
 }
 
 // Scan one batch of query sequences against all database volumes
@@ -1559,15 +2109,51 @@ void scanAllVolumes(int bitsPerBase, int bitsPerInt, bool isCaseSensitive) {
   encodeSequences(qrySeqsGlobal, args.inputFormat, queryAlph,
 		  args.isKeepLowercase, 0);
 
+  // Divide the queries into many more chunks than threads, so that
+  // threads that get quick chunks can take more of them.  A query
+  // longer than an average chunk gets a chunk to itself.
+  const size_t chunksPerThread = 32;
+  size_t numOfThreads = aligners.size();
+  size_t numOfSeqs = qrySeqsGlobal.finishedSequences();
+  size_t numOfChunks = (numOfThreads > 1) ?
+    std::min(numOfSeqs, numOfThreads * chunksPerThread) : 1;
+  queryChunks.clear();
+  queryChunks.resize(std::max(numOfChunks, size_t(1)));
+
+  if (volumes.size() >= numOfVolumes) {
+    // All volumes stay in memory, and each chunk of queries goes
+    // through all of them, so threads work on different volumes at
+    // the same time
+    for (unsigned i = 0; i < numOfVolumes; ++i) {
+      loadVolume(i, bitsPerBase, bitsPerInt, isCaseSensitive);
+    }
+    resetQueryChunks();
+    scanVolumes(0, numOfVolumes, numOfThreads);
+    return;
+  }
+
   for (unsigned i = 0; i < numOfVolumes; ++i) {
-    if (refSeqs.unfinishedSize() == 0 || numOfVolumes > 1) {
-      readVolume(i, bitsPerBase, bitsPerInt, isCaseSensitive);
+    loadVolume(i, bitsPerBase, bitsPerInt, isCaseSensitive);
+    unsigned j = i + 1;
+    bool isPreload = (args.isPreloadVolumes && j < numOfVolumes);
+    resetQueryChunks();
+#ifdef HAS_CXX_THREADS
+    if (isPreload) {
+      std::thread t(preloadVolume, j, bitsPerBase, bitsPerInt,
+		    isCaseSensitive);
+      scanVolumes(i, j, numOfThreads);
+      t.join();
+      continue;
     }
-    scanOneVolume(i, aligners.size());
+#endif
+    scanVolumes(i, j, numOfThreads);
   }
 }
 
 void writeHeader(countT numOfRefSeqs, countT refLetters, std::ostream &out) {
+  if (args.outputFormat == 'r') {
+    out.write(mcf::binaryAlignmentsMagic, mcf::binaryAlignmentsMagicSize);
+  }
   out << "# LAST version " <<
 #include "version.hh"
       << "\n";
@@ -1599,7 +2185,7 @@ void writeHeader(countT numOfRefSeqs, countT refLetters, std::ostream &out) {
       out << "# score\tname1\tstart1\talnSize1\tstrand1\tseqSize1\t"
 	  << "name2\tstart2\talnSize2\tstrand2\tseqSize2\tblocks\n";
     }
-    if( args.outputFormat == 'm' ){
+    if( args.outputFormat == 'm' || args.outputFormat == 'r' ){
       out << "# name start alnSize strand seqSize alignment\n"
 	  << "#\n";
     }
@@ -1655,6 +2241,7 @@ void lastal(int argc, char **argv) {
 
   aligners.resize( decideNumberOfThreads( args.numOfThreads,
 					  args.programName, args.verbosity ) );
+  setFileMapOptions(args.loadMethod, args.isInterleaveNodes, aligners.size());
   bool isMultiVolume = (numOfVolumes + 1 > 0 && numOfVolumes > 1);
   args.setDefaultsFromAlphabet(isDna, isProtein, prj.strand,
 			       prj.isKeepLowercase, prj.tantanSetting,
@@ -1730,7 +2317,7 @@ void lastal(int argc, char **argv) {
   }
   args.setDefaultsFromMatrix(fwdMatrices.stats.lambda(), minScore, eg2);
 
-  minScoreGapless = calcMinScoreGapless(prj.numOfLetters);
+  int minScoreGapless = calcMinScoreGapless(prj.numOfLetters);
   if (!isMultiVolume) args.minScoreGapless = minScoreGapless;
   if (args.outputType > 0) makeQualityScorers(matrixName.empty());
 
@@ -1745,9 +2332,21 @@ void lastal(int argc, char **argv) {
   }
 
   if (numOfVolumes + 1 == 0) {
-    readIndex(args.lastdbName, prj.numOfSeqs, prj.bitsPerBase, prj.bitsPerInt,
-	      prj.isCaseSensitive);
+    std::vector<LastVolume>(1).swap(volumes);
+    LastVolume &vol = volumes[0];
+    readIndex(vol, args.lastdbName, prj.numOfSeqs,
+	      prj.bitsPerBase, prj.bitsPerInt, prj.isCaseSensitive);
+    vol.minScoreGapless = minScoreGapless;
+    vol.volumeNumber = 0;
     numOfVolumes = 1;
+  } else {
+    // how many volumes we can have in memory at once
+    size_t numOfSlots = args.isKeepAllVolumes ? numOfVolumes
+      :                 args.isPreloadVolumes ? 2 : 1;
+    std::vector<LastVolume>(numOfSlots).swap(volumes);
+  }
+  for (size_t i = 0; i < aligners.size(); ++i) {
+    aligners[i].volume = &volumes[0];
   }
 
   writeHeader(prj.numOfSeqs, prj.numOfLetters, std::cout);
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Copy a lastdb database into POSIX shared memory, and keep it there
+// until interrupted.  "lastal --load=shared" then uses these copies,
+// instead of reading the files.
+
+#include "fileMap.hh"
+#include "stringify.hh"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <getopt.h>
+#include <algorithm>  // min
+#include <cerrno>
+#include <cstdlib>  // EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>  // strerror
+#include <fstream>
+#include <iostream>
+#include <new>  // bad_alloc
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+static const char *programName;
+static int verbosity = 0;
+static sigset_t stopSignals;
+
+#define LOG(x) if (verbosity > 0) std::cerr << programName << ": " << x << '\n'
+
+static void err(const std::string &s) {
+  throw std::runtime_error(s + ": " + std::strerror(errno));
+}
+
+struct SharedFile {
+  std::string name;
+  void *memory;
+  size_t size;
+};
+
+static std::vector<SharedFile> sharedFiles;
+
+static void unserveAll() {
+  for (size_t i = 0; i < sharedFiles.size(); ++i) {
+    shm_unlink(sharedFiles[i].name.c_str());
+    munmap(sharedFiles[i].memory, sharedFiles[i].size);
+  }
+  sharedFiles.clear();
+}
+
+// Copy one file into shared memory, and lock it in RAM
+static void serveFile(const std::string &fileName) {
+  int f = open(fileName.c_str(), O_RDONLY);
+  if (f < 0) return;  // lastdb doesn't make all file types
+  struct stat s;
+  if (fstat(f, &s) < 0) err("can't read file " + fileName);
+  size_t size = s.st_size;
+  if (size == 0) {
+    close(f);
+    return;
+  }
+
+  SharedFile sf;
+  sf.name = cbrc::sharedMemoryName(fileName);
+  sf.size = size;
+  // make it unreadable until it's completely copied
+  int m = shm_open(sf.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0);
+  if (m < 0) err("can't make shared memory for " + fileName);
+  if (ftruncate(m, size) < 0) {
+    shm_unlink(sf.name.c_str());
+    err("can't make shared memory for " + fileName);
+  }
+  sf.memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, m, 0);
+  if (sf.memory == MAP_FAILED) {
+    shm_unlink(sf.name.c_str());
+    err("can't map shared memory for " + fileName);
+  }
+  sharedFiles.push_back(sf);
+#ifdef MADV_HUGEPAGE
+  madvise(sf.memory, size, MADV_HUGEPAGE);  // just a hint
+#endif
+
+  char *beg = static_cast<char *>(sf.memory);
+  for (size_t done = 0; done < size; ) {
+    sigset_t pending;
+    sigpending(&pending);
+    for (int i = 1; i < NSIG; ++i) {
+      if (sigismember(&stopSignals, i) && sigismember(&pending, i)) {
+	throw std::runtime_error("interrupted");
+      }
+    }
+    ssize_t r = read(f, beg + done, std::min(size - done, size_t(1) << 30));
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) err("can't read file " + fileName);
+    done += r;
+  }
+  close(f);
+
+  if (mlock(sf.memory, size) < 0) {
+    std::cerr << programName << ": can't lock " << fileName
+	      << " in memory: " << std::strerror(errno) << '\n';
+  }
+  if (fchmod(m, S_IRUSR | S_IRGRP | S_IROTH) < 0) {
+    err("can't share memory for " + fileName);
+  }
+  close(m);
+  LOG(fileName << " -> " << sf.name);
+}
+
+static void serveSequences(const std::string &baseName) {
+  const char *extensions[] = {".ssp", ".sds", ".tis", ".des", ".qua"};
+  for (size_t i = 0; i < sizeof extensions / sizeof *extensions; ++i) {
+    serveFile(baseName + extensions[i]);
+  }
+}
+
+static void serveIndex(const std::string &baseName) {
+  const char *extensions[] = {".suf", ".bck", ".chi", ".chi2", ".chi1"};
+  for (size_t i = 0; i < sizeof extensions / sizeof *extensions; ++i) {
+    serveFile(baseName + extensions[i]);
+  }
+}
+
+static void serveVolume(const std::string &baseName, unsigned numOfIndexes) {
+  LOG("reading " << baseName << "...");
+  serveSequences(baseName);
+  for (unsigned x = 0; x < numOfIndexes; ++x) {
+    if (numOfIndexes > 1) {
+      serveIndex(baseName + char('a' + x));
+    } else {
+      serveIndex(baseName);
+    }
+  }
+}
+
+static void serveDatabase(const std::string &dbName) {
+  std::string fileName = dbName + ".prj";
+  std::ifstream f(fileName.c_str());
+  if (!f) err("can't open file " + fileName);
+  unsigned numOfVolumes = -1;
+  unsigned numOfIndexes = 1;
+  std::string line, word;
+  while (getline(f, line)) {
+    std::istringstream iss(line);
+    getline(iss, word, '=');
+    if (word == "volumes") iss >> numOfVolumes;
+    if (word == "numofindexes") iss >> numOfIndexes;
+  }
+
+  if (numOfVolumes + 1 == 0) {
+    serveVolume(dbName, numOfIndexes);
+  } else {
+    for (unsigned i = 0; i < numOfVolumes; ++i) {
+      std::string baseName = dbName + cbrc::stringify(i);
+      // each volume says how many indexes it has
+      std::ifstream v((baseName + ".prj").c_str());
+      unsigned n = numOfIndexes;
+      while (getline(v, line)) {
+	std::istringstream iss(line);
+	getline(iss, word, '=');
+	if (word == "numofindexes") iss >> n;
+      }
+      serveVolume(baseName, n);
+    }
+  }
+}
+
+static void run(int argc, char *argv[]) {
+  programName = argv[0];
+
+  std::string help = "\
+Usage: " + std::string(argv[0]) + " [options] lastdb-name\n\
+\n\
+Copy a lastdb database into shared memory, and keep it there until\n\
+interrupted.  \"lastal --load=shared\" uses these copies, instead of\n\
+reading the files.\n\
+\n\
+Options:\n\
+ -h, --help     show this help message and exit\n\
+ -V, --version  show version information and exit\n\
+ -v, --verbose  be verbose: write messages about what it's doing\n\
+";
+
+  const char sOpts[] = "hVv";
+
+  static struct option lOpts[] = {
+    { "help",    no_argument, 0, 'h' },
+    { "version", no_argument, 0, 'V' },
+    { "verbose", no_argument, 0, 'v' },
+    { 0, 0, 0, 0}
+  };
+
+  int c;
+  while ((c = getopt_long(argc, argv, sOpts, lOpts, &c)) != -1) {
+    switch (c) {
+    case 'h':
+      std::cout << help;
+      return;
+    case 'V':
+      std::cout << "lastdb-serve "
+#include "version.hh"
+	"\n";
+      return;
+    case 'v':
+      ++verbosity;
+      break;
+    case '?':
+      throw std::runtime_error("");
+    }
+  }
+
+  if (optind != argc - 1) {
+    std::cerr << help;
+    throw std::runtime_error("");
+  }
+
+  // Wait for these signals, instead of dying, so we can clean up
+  sigemptyset(&stopSignals);
+  sigaddset(&stopSignals, SIGINT);
+  sigaddset(&stopSignals, SIGTERM);
+  sigaddset(&stopSignals, SIGHUP);
+  sigprocmask(SIG_BLOCK, &stopSignals, 0);
+
+  try {
+    serveDatabase(argv[optind]);
+  } catch (...) {
+    unserveAll();
+    throw;
+  }
+
+  LOG("serving " << sharedFiles.size() << " files");
+  int sig;
+  sigwait(&stopSignals, &sig);
+  LOG("stopping");
+  unserveAll();
+}
+
+int main(int argc, char *argv[]) {
+  try {
+    run(argc, argv);
+    if (!std::cout.flush()) throw std::runtime_error("write error");
+    return EXIT_SUCCESS;
+  } catch (const std::bad_alloc &e) {  // bad_alloc::what() may be unfriendly
+    std::cerr << argv[0] << ": out of memory\n";
+    return EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    const char *s = e.what();
+    if (*s) std::cerr << argv[0] << ": " << s << '\n';
+    return EXIT_FAILURE;
+  }
+}
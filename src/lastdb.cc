@@ -11,9 +11,14 @@
 #include "stringify.hh"
 #include "threadUtil.hh"
 #include <stdexcept>
+#include <algorithm>  // find
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <cstdio>  // rename
 #include <cstdlib>  // EXIT_SUCCESS, EXIT_FAILURE
+#include <exception>  // exception_ptr
+#include <list>
 #include <numeric>  // accumulate
 
 #define ERR(x) throw std::runtime_error(x)
@@ -96,16 +101,15 @@ void writeLastalOptions( std::ostream& out, const std::string& seedText ){
       out << line << '\n';
 }
 
-void writePrjFile( const std::string& fileName, const LastdbArguments& args,
-		   const Alphabet& alph, countT sequenceCount,
-		   size_t maxSeqLen, const countT *letterCounts,
-		   bool isFastq, unsigned volumes, unsigned numOfIndexes,
-		   const std::string& seedText ){
+static void writePrj( std::ostream& f, const LastdbArguments& args,
+		      const Alphabet& alph, countT sequenceCount,
+		      size_t maxSeqLen, const countT *letterCounts,
+		      bool isFastq, unsigned volumes, unsigned numOfIndexes,
+		      const std::string& seedText ){
   countT letterTotal = std::accumulate(letterCounts,
 				       letterCounts + alph.size, countT(0));
   if (args.isCircular) maxSeqLen = 1e9;  // suppress E-value edge correction
 
-  std::ofstream f( fileName.c_str() );
   f << "version=" <<
 #include "version.hh"
     << '\n';
@@ -147,11 +151,126 @@ void writePrjFile( const std::string& fileName, const LastdbArguments& args,
     f << "symbolsize=" << args.bitsPerBase << '\n';
     writeLastalOptions( f, seedText );
   }
+}
 
+void writePrjFile( const std::string& fileName, const LastdbArguments& args,
+		   const Alphabet& alph, countT sequenceCount,
+		   size_t maxSeqLen, const countT *letterCounts,
+		   bool isFastq, unsigned volumes, unsigned numOfIndexes,
+		   const std::string& seedText ){
+  std::ofstream f( fileName.c_str() );
+  writePrj( f, args, alph, sequenceCount, maxSeqLen, letterCounts,
+	    isFastq, volumes, numOfIndexes, seedText );
   f.close();
   if( !f ) ERR( "can't write file: " + fileName );
 }
 
+// The lines of a .prj file that depend on lastdb's options, not on
+// the sequences
+static std::string prjSettings( std::istream& in ){
+  const char *skip[] = {"version", "numofsequences", "numofletters",
+			"maxsequenceletters", "letterfreqs", "volumes",
+			"numofindexes", "totallength", "specialcharacters",
+			"prefixlength", "subsetseed"};
+  std::string settings, line, word;
+  while( getline( in, line ) ){
+    std::istringstream iss( line );
+    getline( iss, word, '=' );
+    if( std::find( skip, skip + sizeof skip / sizeof *skip, word )
+	== skip + sizeof skip / sizeof *skip ) settings += line + '\n';
+  }
+  return settings;
+}
+
+// Rename the files of a one-volume database, so that it becomes
+// volume 0 of a multi-volume database
+static void renameToVolume0( const std::string& dbName,
+			     unsigned numOfIndexes ){
+  const char *seqExts[] = {".prj", ".ssp", ".sds", ".tis", ".des", ".qua"};
+  const char *idxExts[] = {".prj", ".suf", ".bck", ".chi", ".chi2", ".chi1"};
+  std::vector<std::string> from, to;
+  for( size_t i = 0; i < sizeof seqExts / sizeof *seqExts; ++i ){
+    from.push_back( dbName + seqExts[i] );
+    to.push_back( dbName + '0' + seqExts[i] );
+  }
+  for( unsigned x = 0; x < numOfIndexes; ++x ){
+    std::string suffix = (numOfIndexes > 1) ? std::string(1, 'a' + x) : "";
+    for( size_t i = 0; i < sizeof idxExts / sizeof *idxExts; ++i ){
+      if( suffix.empty() && i == 0 ) continue;  // same as the volume .prj
+      from.push_back( dbName + suffix + idxExts[i] );
+      to.push_back( dbName + '0' + suffix + idxExts[i] );
+    }
+  }
+
+  std::ifstream test( to[0].c_str() );
+  if( test ) ERR( "can't append: " + to[0] + " already exists" );
+
+  for( size_t i = 0; i < from.size(); ++i ){
+    std::ifstream f( from[i].c_str() );
+    if( !f ) continue;  // lastdb doesn't make all file types
+    f.close();
+    if( std::rename( from[i].c_str(), to[i].c_str() ) != 0 )
+      ERR( "can't rename " + from[i] + " to " + to[i] );
+  }
+}
+
+// Read the totals in an existing database's .prj file, check that it
+// was made with the same options, and return its number of volumes.
+// If it has just one volume, make that volume 0.
+static unsigned prepareToAppend( const LastdbArguments& args,
+				 const Alphabet& alph, unsigned numOfIndexes,
+				 const std::string& seedText,
+				 countT& sequenceCount,
+				 std::vector<countT>& letterCounts,
+				 size_t& maxSeqLen, bool& isFastq ){
+  std::string fileName = args.lastdbName + ".prj";
+  std::ifstream file;
+  openOrDie( file, fileName );
+  std::stringstream old;
+  old << file.rdbuf();
+  if( !file ) ERR( "can't read file: " + fileName );
+
+  unsigned volumes = -1;
+  unsigned oldNumOfIndexes = 1;
+  isFastq = false;
+  letterCounts.clear();
+  std::string line, word;
+  while( getline( old, line ) ){
+    std::istringstream iss( line );
+    getline( iss, word, '=' );
+    if( word == "numofsequences" ) iss >> sequenceCount;
+    if( word == "maxsequenceletters" ) iss >> maxSeqLen;
+    if( word == "volumes" ) iss >> volumes;
+    if( word == "numofindexes" ) iss >> oldNumOfIndexes;
+    if( word == "sequenceformat" ) isFastq = true;
+    if( word == "letterfreqs" ){
+      countT c;
+      while( iss >> c ) letterCounts.push_back( c );
+    }
+  }
+
+  std::vector<countT> zeros( alph.size );
+  std::stringstream now;
+  writePrj( now, args, alph, 0, 0, &zeros[0], isFastq, 0,
+	    numOfIndexes, seedText );
+  old.clear();
+  old.seekg( 0 );
+  if( prjSettings( old ) != prjSettings( now ) )
+    ERR( "can't append: the options differ from those used for "
+	 + args.lastdbName );
+  if( letterCounts.size() != alph.size ) ERR( "can't read file: " + fileName );
+
+  if( volumes + 1 == 0 ){
+    renameToVolume0( args.lastdbName, oldNumOfIndexes );
+    volumes = 1;
+    writePrjFile( fileName, args, alph, sequenceCount, maxSeqLen,
+		  &letterCounts[0], isFastq, volumes, numOfIndexes,
+		  seedText );
+  }
+
+  return volumes;
+}
+
 static void preprocessSomeSeqs(MultiSequence &multi, countT *letterCounts,
 			       size_t *maxSeqLen, size_t *wordCounts,
 			       const LastdbArguments &args,
@@ -174,11 +293,31 @@ static void preprocessSomeSeqs(MultiSequence &multi, countT *letterCounts,
     size_t t = std::accumulate(letterCounts, letterCounts + alph.size, zero);
     *maxSeqLen = std::max(*maxSeqLen, t - letterTotal);
     letterTotal = t;
+    if (isMask && e - b > TantanMasker::windowStep) continue;  // do it later
     if (isMask) masker.mask(b, e, alph.numbersToLowercase);
     if (isWord) wordsFinder.count(b, e, wordCounts);
   }
 }
 
+// Mask long sequences, which preprocessSomeSeqs skipped, using all the
+// threads for each one
+static void maskLongSeqs(MultiSequence &multi, size_t *wordCounts,
+			 const LastdbArguments &args, const Alphabet &alph,
+			 const TantanMasker &masker,
+			 const DnaWordsFinder &wordsFinder,
+			 unsigned numOfThreads) {
+  if (!args.tantanSetting || args.isCountsOnly) return;
+  bool isWord = wordsFinder.wordLength;
+  size_t numOfSequences = multi.finishedSequences();
+  for (size_t i = 0; i < numOfSequences; ++i) {
+    uchar *b = multi.seqWriter() + multi.seqBeg(i);
+    uchar *e = multi.seqWriter() + multi.seqEnd(i);
+    if (e - b <= TantanMasker::windowStep) continue;
+    masker.mask(b, e, alph.numbersToLowercase, numOfThreads);
+    if (isWord) wordsFinder.count(b, e, wordCounts);
+  }
+}
+
 static void preprocessSeqs(MultiSequence *multi, countT *letterCounts,
 			   size_t *maxSeqLen, size_t *wordCounts,
 			   const LastdbArguments *args, const Alphabet *alph,
@@ -205,6 +344,75 @@ static void preprocessSeqs(MultiSequence *multi, countT *letterCounts,
   }
 }
 
+// Count the positions in [textBeg, textEnd) that get indexed, and if
+// "index" isn't null, store them in the index starting at "saPos"
+static size_t findIndexedPositions(SubsetSuffixArray *index, size_t saPos,
+				   const MultiSequence &multi,
+				   const CyclicSubsetSeed &seed,
+				   size_t window, size_t step,
+				   size_t textBeg, size_t textEnd) {
+  const uchar *seq = multi.seqReader();
+  const uchar *subsetMap = seed.firstMap();
+  size_t numOfSequences = multi.finishedSequences();
+  SubsetMinimizerFinder f;
+  size_t count = 0;
+  if (textBeg >= textEnd) return 0;
+
+  for (size_t i = multi.whichSequence(textBeg); i < numOfSequences; ++i) {
+    size_t seqBeg = multi.seqBeg(i);
+    size_t seqEnd = multi.seqEnd(i);
+    if (seqBeg >= textEnd) break;
+    size_t pos = seqBeg;
+    if (textBeg > seqBeg) pos += (textBeg - seqBeg + step - 1) / step * step;
+    size_t end = std::min(seqEnd, textEnd);
+    if (pos >= end) continue;
+    // Minimizers depend on the preceding window only, so we can start
+    // part-way along a sequence and get the same result
+    size_t initPos = (pos - seqBeg < window) ? seqBeg : pos - (window - 1);
+    f.init(seed, seq + initPos, seq + seqEnd);
+    while (pos < end) {
+      const uchar *p = seq + pos;
+      if ((window > 1) ? f.isMinimizer(seed, p, seq + seqEnd, window) :
+	  (subsetMap[*p] < CyclicSubsetSeed::DELIMITER)) {
+	if (index) index->setPosition(saPos + count, pos);
+	++count;
+      }
+      pos += std::min(step, end - pos);
+    }
+  }
+
+  return count;
+}
+
+// Divide the text into chunks, and do findIndexedPositions for each
+// chunk in its own thread.  For chunk k, counts[k] is input as saPos,
+// and replaced by the number of positions.
+static void findIndexedPositionsInChunks(SubsetSuffixArray *index,
+					 size_t *counts,
+					 const MultiSequence *multi,
+					 const CyclicSubsetSeed *seed,
+					 size_t window, size_t step,
+					 size_t numOfChunks, size_t chunkNum) {
+  size_t beg = multi->seqBeg(0);
+  unsigned long long len = multi->seqBeg(multi->finishedSequences()) - beg;
+  size_t textBeg = beg + len * chunkNum / numOfChunks;
+  size_t textEnd = beg + len * (chunkNum + 1) / numOfChunks;
+  if (chunkNum + 1 < numOfChunks) {
+#ifdef HAS_CXX_THREADS
+    std::thread t(findIndexedPositionsInChunks, index, counts, multi, seed,
+		  window, step, numOfChunks, chunkNum + 1);
+    counts[chunkNum] = findIndexedPositions(index, counts[chunkNum], *multi,
+					    *seed, window, step,
+					    textBeg, textEnd);
+    t.join();
+#endif
+  } else {
+    counts[chunkNum] = findIndexedPositions(index, counts[chunkNum], *multi,
+					    *seed, window, step,
+					    textBeg, textEnd);
+  }
+}
+
 // Make one database volume, from one batch of sequences
 void makeVolume(std::vector<CyclicSubsetSeed>& seeds,
 		const DnaWordsFinder& wordsFinder, MultiSequence& multi,
@@ -225,6 +433,8 @@ void makeVolume(std::vector<CyclicSubsetSeed>& seeds,
   LOG("preprocessing...");
   preprocessSeqs(&multi, &letterCounts[0], maxSeqLen, wordCounts,
 		 &args, &alph, &masker, &wordsFinder, numOfThreads, 0);
+  maskLongSeqs(multi, wordCounts, args, alph, masker, wordsFinder,
+	       numOfThreads);
 
   for (unsigned c = 0; c < alph.size; ++c) {
     letterCountsSeen[c] += letterCounts[c];
@@ -251,38 +461,34 @@ void makeVolume(std::vector<CyclicSubsetSeed>& seeds,
     } else {
       indexSeeds.resize(1);
       seeds[x].swap(indexSeeds[0]);
-      SubsetMinimizerFinder f;
+      const CyclicSubsetSeed *seed = &indexSeeds[0];
       size_t window = args.minimizerWindow;
-      const CyclicSubsetSeed &seed = indexSeeds[0];
-      const uchar *subsetMap = seed.firstMap();
-      size_t count = 0;
+      size_t step = args.indexStep;
+      std::vector<size_t> counts(numOfThreads);
       LOG("counting...");
-      for (size_t i = 0; i < numOfSequences; ++i) {
-	const uchar *beg = seq + multi.seqBeg(i);
-	const uchar *end = seq + multi.seqEnd(i);
-	f.init(seed, beg, end);
-	while (beg < end) {
-	  count += (window > 1) ? f.isMinimizer(seed, beg, end, window) :
-	    (subsetMap[*beg] < CyclicSubsetSeed::DELIMITER);
-	  size_t d = end - beg;
-	  beg += std::min(args.indexStep, d);
-	}
-      }
+      findIndexedPositionsInChunks(0, &counts[0], &multi, seed,
+				   window, step, numOfThreads, 0);
+      size_t count = std::accumulate(counts.begin(), counts.end(), size_t(0));
       LOG("gathering...");
       myIndex.resizePositions(count, textLength, numOfThreads);
-      count = 0;
-      for (size_t i = 0; i < numOfSequences; ++i) {
-	const uchar *beg = seq + multi.seqBeg(i);
-	const uchar *end = seq + multi.seqEnd(i);
-	f.init(seed, beg, end);
-	while (beg < end) {
-	  if ((window > 1) ? f.isMinimizer(seed, beg, end, window) :
-	      (subsetMap[*beg] < CyclicSubsetSeed::DELIMITER))
-	    myIndex.setPosition(count++, beg - seq);
-	  size_t d = end - beg;
-	  beg += std::min(args.indexStep, d);
+      // leave gaps between the threads' outputs, so they can write at
+      // the same time, then close the gaps
+      size_t gap = myIndex.positionsBetweenThreads();
+      std::vector<size_t> starts(numOfThreads + 1);
+      for (unsigned t = 0; t < numOfThreads; ++t) {
+	starts[t + 1] = starts[t] + counts[t];
+	counts[t] = starts[t] + gap * t;
+      }
+      findIndexedPositionsInChunks(&myIndex, &counts[0], &multi, seed,
+				   window, step, numOfThreads, 0);
+      for (unsigned t = 1; t < numOfThreads; ++t) {
+	for (size_t i = starts[t]; i < starts[t + 1]; ++i) {
+	  myIndex.setPosition(i, myIndex.getPosition(i + gap * t));
 	}
       }
+      for (size_t i = count; i < count + gap * (numOfThreads - 1); ++i) {
+	myIndex.setPosition(i, 0);
+      }
       wordCounts[0] = count;
     }
 
@@ -314,6 +520,107 @@ void makeVolume(std::vector<CyclicSubsetSeed>& seeds,
   LOG( "done!" );
 }
 
+// One volume's sequences, which may be made into a volume in a
+// background thread, while the next sequences are read
+struct VolumeJob {
+  MultiSequence multi;
+  std::vector<CyclicSubsetSeed> seeds;
+  std::vector<countT> letterCounts;
+  size_t maxSeqLen;
+  std::string baseName;
+  std::exception_ptr error;
+#ifdef HAS_CXX_THREADS
+  std::thread thread;
+  ~VolumeJob() { if (thread.joinable()) thread.join(); }
+#endif
+};
+
+// The last one is being read, the others are being made into volumes
+typedef std::list<VolumeJob> VolumeJobs;
+
+static void makeVolumeJob(VolumeJob *job, const DnaWordsFinder *wordsFinder,
+			  const LastdbArguments *args, const Alphabet *alph,
+			  const TantanMasker *masker, unsigned numOfThreads,
+			  const std::string *seedText) {
+  try {
+    makeVolume(job->seeds, *wordsFinder, job->multi, *args, *alph,
+	       job->letterCounts, job->maxSeqLen, *masker, numOfThreads,
+	       *seedText, job->baseName);
+  } catch (...) {
+    job->error = std::current_exception();
+  }
+}
+
+// Wait for the oldest volume to be made, and add up its letter counts
+static void finishOldestVolume(VolumeJobs &jobs,
+			       std::vector<countT> &letterCountsSeen,
+			       size_t &maxSeqLenSeen) {
+  VolumeJob &job = jobs.front();
+#ifdef HAS_CXX_THREADS
+  job.thread.join();
+#endif
+  if (job.error) std::rethrow_exception(job.error);
+  for (size_t c = 0; c < letterCountsSeen.size(); ++c) {
+    letterCountsSeen[c] += job.letterCounts[c];
+  }
+  maxSeqLenSeen = std::max(maxSeqLenSeen, job.maxSeqLen);
+  jobs.pop_front();
+}
+
+// Make a volume from the finished sequences being read, and keep
+// those from keptSeqNum onwards for the next volume.  If
+// args.volumesAtOnce > 1, do it in a background thread, so that
+// reading the next volume overlaps with making this one.
+static MultiSequence *makeVolumeAndKeep(VolumeJobs &jobs, size_t keptSeqNum,
+					std::vector<CyclicSubsetSeed> &seeds,
+					const DnaWordsFinder &wordsFinder,
+					const LastdbArguments &args,
+					const Alphabet &alph,
+					std::vector<countT> &letterCountsSeen,
+					size_t &maxSeqLenSeen,
+					const TantanMasker &masker,
+					unsigned numOfThreads,
+					const std::string &seedText,
+					const std::string &baseName) {
+  MultiSequence &multi = jobs.back().multi;
+
+#ifdef HAS_CXX_THREADS
+  if (args.volumesAtOnce > 1) {
+    while (jobs.size() >= args.volumesAtOnce) {
+      finishOldestVolume(jobs, letterCountsSeen, maxSeqLenSeen);
+    }
+    VolumeJob &job = jobs.back();
+    jobs.emplace_back();
+    MultiSequence &next = jobs.back().multi;
+    next.reinitFromSequences(multi, keptSeqNum);
+    if (next.finishedSequences() && args.tantanSetting && !args.isCountsOnly) {
+      // mask it as makeVolume will, so the next volume gets it masked
+      // just as without --pipeline
+      uchar *b = next.seqWriter() + next.seqBeg(0);
+      uchar *e = next.seqWriter() + next.seqEnd(0);
+      masker.mask(b, e, alph.numbersToLowercase, numOfThreads);
+    }
+    job.seeds = seeds;
+    job.letterCounts.assign(alph.size, 0);
+    job.maxSeqLen = 0;
+    job.baseName = baseName;
+    job.thread = std::thread(makeVolumeJob, &job, &wordsFinder, &args,
+			     &alph, &masker, numOfThreads, &seedText);
+    return &jobs.back().multi;
+  }
+#endif
+
+  makeVolume(seeds, wordsFinder, multi, args, alph, letterCountsSeen,
+	     maxSeqLenSeen, masker, numOfThreads, seedText, baseName);
+  if (keptSeqNum < multi.finishedSequences()) {
+    if (args.bitsPerBase == 4) multi.convertTo8bit();
+    multi.eraseAllButTheLastSequence();
+  } else {
+    multi.reinitForAppending();
+  }
+  return &multi;
+}
+
 // The max number of sequence letters, such that the total volume size
 // is likely to be less than volumeSize bytes.  (This is crude, it
 // neglects memory for the sequence names, and the fact that
@@ -457,8 +764,9 @@ void lastdb( int argc, char** argv ){
     err("error: word-restricted DNA seeds on protein");
   LOG("wordLength=" << wordsFinder.wordLength);
 
-  MultiSequence multi;
-  initSequences(multi, alph, false, args.isAddStops);
+  VolumeJobs volumeJobs(1);
+  MultiSequence *multi = &volumeJobs.back().multi;
+  initSequences(*multi, alph, false, args.isAddStops);
   unsigned volumeNumber = 0;
   countT sequenceCount = 0;
   std::vector<countT> letterCounts( alph.size );
@@ -466,6 +774,15 @@ void lastdb( int argc, char** argv ){
   size_t maxSeqLen = -1;
   size_t maxSeqLenSeen = 0;
 
+  // totals for the sequences already in the database, if appending
+  countT oldSequenceCount = 0;
+  bool isFastqDb = false;
+  if (args.isAppend) {
+    volumeNumber = prepareToAppend(args, alph, seeds.size(), seedText,
+				   oldSequenceCount, letterCounts,
+				   maxSeqLenSeen, isFastqDb);
+  }
+
   char defaultInputName[] = "-";
   char* defaultInput[] = { defaultInputName, 0 };
   char** inputBegin = argv + args.inputStart;
@@ -475,17 +792,21 @@ void lastdb( int argc, char** argv ){
     std::istream& in = openIn( *i, inFileStream );
     LOG( "reading " << *i << "..." );
 
-    while (appendSequence(multi, in, maxSeqLen, args.inputFormat,
+    while (appendSequence(*multi, in, maxSeqLen, args.inputFormat,
 			  args.isCircular, alph, 0)) {
-      if (multi.isFinished()) {
-	encodeSequences(multi, args.inputFormat, alph, args.isKeepLowercase,
-			multi.finishedSequences() - 1);
+      if (multi->isFinished()) {
+	encodeSequences(*multi, args.inputFormat, alph, args.isKeepLowercase,
+			multi->finishedSequences() - 1);
 	if (sequenceCount == 0) {
+	  if (args.isAppend && (multi->qualsPerLetter() > 0) != isFastqDb) {
+	    ERR("can't append: the sequence format differs from that of "
+		+ args.lastdbName);
+	  }
 	  maxLetters = maxLettersPerVolume(args, wordsFinder,
-					   multi.qualsPerLetter(),
+					   multi->qualsPerLetter(),
 					   seeds.size());
 	  if (!args.isProtein && !args.isAddStops &&
-	      args.userAlphabet.empty() && isDubiousDna(alph, multi)) {
+	      args.userAlphabet.empty() && isDubiousDna(alph, *multi)) {
 	    std::cerr << args.programName
 		      << ": that's some funny-lookin DNA\n";
 	  }
@@ -494,49 +815,55 @@ void lastdb( int argc, char** argv ){
 	if (args.strand != 1) {
 	  if (args.strand == 2) {
 	    ++sequenceCount;
-	    if (isRoomToDuplicateTheLastSequence(multi, maxSeqLen)) {
-	      size_t lastSeq = multi.finishedSequences() - 1;
-	      multi.duplicateOneSequence(lastSeq);
+	    if (isRoomToDuplicateTheLastSequence(*multi, maxSeqLen)) {
+	      size_t lastSeq = multi->finishedSequences() - 1;
+	      multi->duplicateOneSequence(lastSeq);
 	    } else {
 	      std::string baseName =
 		args.lastdbName + stringify(volumeNumber++);
-	      makeVolume(seeds, wordsFinder, multi, args, alph, letterCounts,
-			 maxSeqLenSeen, tantanMasker, numOfThreads, seedText,
-			 baseName);
-	      if (args.bitsPerBase == 4) multi.convertTo8bit();
-	      multi.eraseAllButTheLastSequence();
+	      multi = makeVolumeAndKeep(volumeJobs,
+					multi->finishedSequences() - 1,
+					seeds, wordsFinder, args, alph,
+					letterCounts, maxSeqLenSeen,
+					tantanMasker, numOfThreads, seedText,
+					baseName);
 	    }
 	  }
-	  size_t lastSeq = multi.finishedSequences() - 1;
-	  multi.reverseComplementOneSequence(lastSeq, alph.complement);
+	  size_t lastSeq = multi->finishedSequences() - 1;
+	  multi->reverseComplementOneSequence(lastSeq, alph.complement);
 	}
         ++sequenceCount;
       } else {
-	if (multi.finishedSequences() == 0) throwSeqTooBig();
+	if (multi->finishedSequences() == 0) throwSeqTooBig();
 	std::string baseName = args.lastdbName + stringify(volumeNumber++);
-	makeVolume(seeds, wordsFinder, multi, args, alph, letterCounts,
-		   maxSeqLenSeen, tantanMasker, numOfThreads, seedText,
-		   baseName);
-	multi.reinitForAppending();
+	multi = makeVolumeAndKeep(volumeJobs, multi->finishedSequences(),
+				  seeds, wordsFinder, args, alph,
+				  letterCounts, maxSeqLenSeen, tantanMasker,
+				  numOfThreads, seedText, baseName);
 	maxSeqLen = -1;
       }
     }
   }
 
-  if( multi.finishedSequences() > 0 ){
+  while (volumeJobs.size() > 1) {
+    finishOldestVolume(volumeJobs, letterCounts, maxSeqLenSeen);
+  }
+
+  if( multi->finishedSequences() > 0 ){
     if( volumeNumber == 0 && !args.isCountsOnly ){
-      makeVolume(seeds, wordsFinder, multi, args, alph, letterCounts,
+      makeVolume(seeds, wordsFinder, *multi, args, alph, letterCounts,
 		 maxSeqLenSeen, tantanMasker, numOfThreads, seedText,
 		 args.lastdbName);
       return;
     }
     std::string baseName = args.lastdbName + stringify(volumeNumber++);
-    makeVolume(seeds, wordsFinder, multi, args, alph, letterCounts,
+    makeVolume(seeds, wordsFinder, *multi, args, alph, letterCounts,
 	       maxSeqLenSeen, tantanMasker, numOfThreads, seedText, baseName);
   }
 
-  writePrjFile( args.lastdbName + ".prj", args, alph, sequenceCount,
-		maxSeqLenSeen, &letterCounts[0], multi.qualsPerLetter(),
+  writePrjFile( args.lastdbName + ".prj", args, alph,
+		oldSequenceCount + sequenceCount, maxSeqLenSeen,
+		&letterCounts[0], multi->qualsPerLetter() || isFastqDb,
 		volumeNumber, seeds.size(), seedText );
 }
 
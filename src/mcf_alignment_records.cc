@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mcf_alignment_records.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace mcf {
+
+static void err(const std::string &s) {
+  throw std::runtime_error(s);
+}
+
+static char *nextString(char *s, size_t length, bool isPresent) {
+  return isPresent ? s + length + 1 : s;
+}
+
+void parseAlignmentRecord(AlignmentRecord &r, char *data) {
+  memcpy(&r.head, data, sizeof r.head);
+  r.alnData = data + sizeof r.head;
+  memcpy(&r.aln, r.alnData, sizeof r.aln);
+  char *s = r.alnData + sizeof r.aln;
+  r.rname = s;
+  s += strlen(s) + 1;
+  r.qname = s;
+  s += strlen(s) + 1;
+  r.ralign = s;
+  r.alnLength = strlen(s);
+  s += r.alnLength + 1;
+  r.qalign = s;
+  s += r.alnLength + 1;
+  r.qqual = r.aln.isQual ? s : 0;
+  s = nextString(s, r.alnLength, r.aln.isQual);
+  r.probs = r.aln.isProbs ? s : 0;
+  s = nextString(s, r.alnLength, r.aln.isProbs);
+  r.rqual = r.head.isRefQual ? s : 0;
+  s = nextString(s, r.alnLength, r.head.isRefQual);
+  r.cLine = r.aln.isCounts ? s : 0;
+}
+
+void AlignmentRecordReader::open(const std::string &fileName,
+				 std::istream *stream) {
+  close();
+  bufPos = 0;
+  bufEnd = 0;
+
+  if (fileName == "-") {
+    in = stream ? stream : &std::cin;
+  } else {
+    int f = ::open(fileName.c_str(), O_RDONLY);
+    if (f < 0) err("can't open file: " + fileName);
+    struct stat s;
+    if (fstat(f, &s) < 0) {
+      ::close(f);
+      err("can't read file: " + fileName);
+    }
+    if (S_ISREG(s.st_mode) && s.st_size > 0) {
+      void *m = mmap(0, s.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, f, 0);
+      ::close(f);
+      if (m == MAP_FAILED) err("can't map file: " + fileName);
+      mapBeg = static_cast<char *>(m);
+      mapSize = s.st_size;
+      bufEnd = mapSize;
+#ifdef MADV_SEQUENTIAL
+      madvise(mapBeg, mapSize, MADV_SEQUENTIAL);  // just a hint
+#endif
+    } else if (stream) {
+      ::close(f);
+      in = stream;
+    } else {  // maybe a named pipe: read it like a stream
+      ::close(f);
+      file.open(fileName.c_str());
+      if (!file) err("can't open file: " + fileName);
+      in = &file;
+    }
+  }
+
+  if (!fill(binaryAlignmentsMagicSize) ||
+      memcmp(at(0), binaryAlignmentsMagic, binaryAlignmentsMagicSize)) {
+    err("not binary alignments: " + fileName);
+  }
+  nextPos = binaryAlignmentsMagicSize;
+}
+
+void AlignmentRecordReader::close() {
+  if (mapBeg) munmap(mapBeg, mapSize);
+  mapBeg = 0;
+  mapSize = 0;
+  if (file.is_open()) file.close();
+  file.clear();
+  in = 0;
+  std::vector<char>().swap(buf);
+}
+
+bool AlignmentRecordReader::fill(size_t pos) {
+  if (mapBeg) return pos <= mapSize;
+  while (bufPos + bufEnd < pos) {
+    if (bufEnd == buf.size()) {
+      buf.resize(std::max(buf.size() * 2, size_t(1) << 16));
+    }
+    size_t n = in->rdbuf()->sgetn(buf.data() + bufEnd, buf.size() - bufEnd);
+    if (n == 0) return false;
+    bufEnd += n;
+  }
+  return true;
+}
+
+bool AlignmentRecordReader::next(size_t &pos, bool &isRecord) {
+  size_t p = nextPos;
+  if (!fill(p + 1)) return false;
+
+  if (*at(p) == 0) {
+    uint32_t size;
+    if (!fill(p + recordPrefixSize)) err("truncated binary alignment");
+    memcpy(&size, at(p) + 1, sizeof size);
+    pos = p + recordPrefixSize;
+    nextPos = pos + size;
+    if (!fill(nextPos)) err("truncated binary alignment");
+    isRecord = true;
+    return true;
+  }
+
+  for (size_t q = p; ; ) {
+    size_t available = bufPos + bufEnd - q;
+    char *s = at(q);
+    char *e = static_cast<char *>(memchr(s, '\n', available));
+    if (e) {
+      *e = 0;
+      nextPos = q + (e - s) + 1;
+      break;
+    }
+    q += available;
+    if (!fill(q + 1)) err("missing newline at the end of the input");
+  }
+  pos = p;
+  isRecord = false;
+  return true;
+}
+
+void AlignmentRecordReader::discardBefore(size_t pos) {
+  if (mapBeg) return;
+  size_t n = pos - bufPos;
+  if (n < bufEnd - n) return;  // moving the rest would cost more
+  memmove(buf.data(), buf.data() + n, bufEnd - n);
+  bufEnd -= n;
+  bufPos = pos;
+}
+
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// lastal -f binary writes alignments as binary records, instead of
+// text, so that downstream programs needn't parse text.  The output
+// starts with binaryAlignmentsMagic.  Then it has text lines (such as
+// "#" comment lines) and records.  Each record is: a zero byte, the
+// size of the rest of the record (a 4-byte integer), an
+// AlignmentRecordHead, a cbrc::UnsplitAlignmentHead, and these
+// 0-terminated strings: the reference name, the query name, the
+// aligned reference letters, the aligned query letters, and
+// optionally the aligned query qualities, the column probability
+// symbols, the aligned reference qualities, and the MAF "c" line.
+// Numbers are in the byte order of the computer that wrote them.
+
+#ifndef MCF_ALIGNMENT_RECORDS_HH
+#define MCF_ALIGNMENT_RECORDS_HH
+
+#include "split/cbrc_unsplit_alignment.hh"
+
+#include <stdint.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace mcf {
+
+const char binaryAlignmentsMagic[] = "\0LAST binary alignments 1\n";
+const size_t binaryAlignmentsMagicSize = sizeof binaryAlignmentsMagic - 1;
+
+const size_t recordPrefixSize = 1 + sizeof(uint32_t);
+
+struct AlignmentRecordHead {
+  double score;
+  double fullScore;  // as in cbrc::AlignmentExtras
+  double eg2;        // these 3 are only meaningful if isEvalue
+  double evalue;
+  double bitScore;
+  bool isEvalue;
+  bool isRefQual;
+};
+
+// The parts of one record
+struct AlignmentRecord {
+  AlignmentRecordHead head;
+  cbrc::UnsplitAlignmentHead aln;
+  char *alnData;  // starts with the cbrc::UnsplitAlignmentHead
+  const char *rname;
+  const char *qname;
+  const char *ralign;
+  const char *qalign;
+  const char *qqual;   // null if absent
+  const char *probs;   // null if absent
+  const char *rqual;   // null if absent
+  const char *cLine;   // null if absent
+  size_t alnLength;
+};
+
+// "data" points to the start of a record's AlignmentRecordHead
+void parseAlignmentRecord(AlignmentRecord &r, char *data);
+
+// Does the input start with binaryAlignmentsMagic?  This only peeks
+// at the first byte.
+inline bool isBinaryAlignments(std::istream &in) {
+  return in.rdbuf()->sgetc() == 0;
+}
+
+// Reads text lines and records.  It maps a file into memory
+// (privately, so that the records can be modified in place), or it
+// reads the standard input into a buffer.  A text line's newline is
+// replaced by a zero byte.
+class AlignmentRecordReader {
+public:
+  AlignmentRecordReader() : mapBeg(0), mapSize(0), in(0) {}
+  ~AlignmentRecordReader() { close(); }
+
+  // Use this file, or the standard input if fileName is "-".  If the
+  // file is already open as "stream", and it can't be mapped (e.g. it
+  // is a pipe), it is read from "stream".  This throws a runtime_error
+  // if the input doesn't start with binaryAlignmentsMagic.
+  void open(const std::string &fileName, std::istream *stream = 0);
+
+  void close();
+
+  // Get the position in the input of the next text line, or the
+  // next record's AlignmentRecordHead.  Returns false at the end.
+  bool next(size_t &pos, bool &isRecord);
+
+  // The input from "pos" onwards, up to the end of the last item from
+  // next().  This pointer is only valid until the next call of next(),
+  // but the input stays available until discardBefore(pos) is called.
+  char *at(size_t pos) { return bufBeg() + (pos - bufPos); }
+
+  // We no longer need the input before "pos".  (It may be kept for
+  // a while, to avoid moving the rest of the input too often.)
+  void discardBefore(size_t pos);
+
+private:
+  char *mapBeg;
+  size_t mapSize;
+  std::istream *in;
+  std::ifstream file;
+  std::vector<char> buf;
+  size_t bufPos;  // position in the input of the start of the buffer
+  size_t bufEnd;  // how much of the buffer has input
+  size_t nextPos;
+
+  char *bufBeg() { return mapBeg ? mapBeg : buf.data(); }
+  bool fill(size_t pos);  // make the input up to pos available
+};
+
+}
+
+#endif
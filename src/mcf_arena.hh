@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// A bump allocator: it hands out memory piece by piece, and takes it
+// all back at once.  The memory blocks are kept for re-use, so a
+// steady workload stops calling the system allocator.
+
+#ifndef MCF_ARENA_HH
+#define MCF_ARENA_HH
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+namespace mcf {
+
+class Arena {
+public:
+  Arena() : blockNum(0), used(0) {}
+
+  char *alloc(size_t size) {
+    for (; blockNum < blocks.size(); ++blockNum, used = 0) {
+      std::vector<char> &b = blocks[blockNum];
+      if (b.size() - used >= size) {
+	char *p = b.data() + used;
+	used += size;
+	return p;
+      }
+    }
+    size_t s = blocks.empty() ? size_t(minBlockSize)
+      : std::min(blocks.back().size() * 2, size_t(maxBlockSize));
+    blocks.push_back(std::vector<char>(std::max(s, size)));
+    blockNum = blocks.size() - 1;
+    used = size;
+    return blocks.back().data();
+  }
+
+  // Take back p and everything allocated after it, if p was allocated
+  // in the current block.  Otherwise, do nothing.
+  void unwind(const char *p) {
+    if (blockNum < blocks.size()) {
+      const char *b = blocks[blockNum].data();
+      if (p >= b && p <= b + used) used = p - b;
+    }
+  }
+
+  // Take back everything (without freeing it)
+  void reset() {
+    blockNum = 0;
+    used = 0;
+  }
+
+  void swap(Arena &a) {
+    blocks.swap(a.blocks);
+    std::swap(blockNum, a.blockNum);
+    std::swap(used, a.used);
+  }
+
+private:
+  enum { minBlockSize = 1 << 16, maxBlockSize = 1 << 26 };
+  std::vector< std::vector<char> > blocks;
+  size_t blockNum;  // the block we're allocating from
+  size_t used;  // how much of that block is allocated
+};
+
+}
+
+#endif
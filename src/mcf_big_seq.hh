@@ -57,6 +57,14 @@ inline BigPtr operator+(BigSeq s, size_t i) {
   return p;
 }
 
+// Ask the CPU to start fetching the i-th element into the cache,
+// because we will read it soon
+inline void prefetch(BigSeq s, size_t i) {
+#ifdef __GNUC__
+  __builtin_prefetch(s.beg + (i >> s.is4bit));
+#endif
+}
+
 }
 
 #endif
@@ -14,7 +14,193 @@
 
 namespace mcf {
 
-#if defined __AVX2__
+#if defined __AVX512BW__
+
+// Some versions of g++ give false warnings inside the AVX-512 headers
+#if defined __GNUC__ && !defined __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+typedef __m512i SimdInt;
+typedef __m512i SimdUint1;
+typedef __m512d SimdDbl;
+typedef __mmask16 SimdMask;
+
+const int simdBytes = 64;
+
+static inline SimdInt simdZero() {
+  return _mm512_setzero_si512();
+}
+
+static inline SimdInt simdZero1() {
+  return _mm512_setzero_si512();
+}
+
+static inline SimdDbl simdZeroDbl() {
+  return _mm512_setzero_pd();
+}
+
+static inline SimdInt simdOnes1() {
+  return _mm512_set1_epi32(-1);
+}
+
+static inline SimdInt simdLoad(const void *p) {
+  return _mm512_loadu_si512(p);
+}
+
+static inline SimdInt simdLoad1(const void *p) {
+  return _mm512_loadu_si512(p);
+}
+
+static inline SimdDbl simdLoadDbl(const double *p) {
+  return _mm512_loadu_pd(p);
+}
+
+static inline void simdStore(void *p, SimdInt x) {
+  _mm512_storeu_si512(p, x);
+}
+
+static inline void simdStore1(void *p, SimdInt x) {
+  _mm512_storeu_si512(p, x);
+}
+
+static inline void simdStoreDbl(double *p, SimdDbl x) {
+  _mm512_storeu_pd(p, x);
+}
+
+static inline SimdInt simdOr1(SimdInt x, SimdInt y) {
+  return _mm512_or_si512(x, y);
+}
+
+static inline SimdInt simdBlend(SimdInt x, SimdInt y, SimdMask mask) {
+  return _mm512_mask_blend_epi32(mask, x, y);
+}
+
+const int simdLen = 16;
+const int simdDblLen = 8;
+
+static inline SimdInt simdSet(int iF, int iE, int iD, int iC,
+			      int iB, int iA, int i9, int i8,
+			      int i7, int i6, int i5, int i4,
+			      int i3, int i2, int i1, int i0) {
+  return _mm512_set_epi32(iF, iE, iD, iC, iB, iA, i9, i8,
+			  i7, i6, i5, i4, i3, i2, i1, i0);
+}
+
+static inline SimdInt simdSet1(char lF, char lE, char lD, char lC,
+			       char lB, char lA, char l9, char l8,
+			       char l7, char l6, char l5, char l4,
+			       char l3, char l2, char l1, char l0,
+			       char kF, char kE, char kD, char kC,
+			       char kB, char kA, char k9, char k8,
+			       char k7, char k6, char k5, char k4,
+			       char k3, char k2, char k1, char k0,
+			       char jF, char jE, char jD, char jC,
+			       char jB, char jA, char j9, char j8,
+			       char j7, char j6, char j5, char j4,
+			       char j3, char j2, char j1, char j0,
+			       char iF, char iE, char iD, char iC,
+			       char iB, char iA, char i9, char i8,
+			       char i7, char i6, char i5, char i4,
+			       char i3, char i2, char i1, char i0) {
+  return _mm512_set_epi8(lF, lE, lD, lC, lB, lA, l9, l8,
+			 l7, l6, l5, l4, l3, l2, l1, l0,
+			 kF, kE, kD, kC, kB, kA, k9, k8,
+			 k7, k6, k5, k4, k3, k2, k1, k0,
+			 jF, jE, jD, jC, jB, jA, j9, j8,
+			 j7, j6, j5, j4, j3, j2, j1, j0,
+			 iF, iE, iD, iC, iB, iA, i9, i8,
+			 i7, i6, i5, i4, i3, i2, i1, i0);
+}
+
+static inline SimdDbl simdSetDbl(double i7, double i6, double i5, double i4,
+				 double i3, double i2, double i1, double i0) {
+  return _mm512_set_pd(i7, i6, i5, i4, i3, i2, i1, i0);
+}
+
+static inline SimdInt simdFill(int x) {
+  return _mm512_set1_epi32(x);
+}
+
+static inline SimdInt simdFill1(char x) {
+  return _mm512_set1_epi8(x);
+}
+
+static inline SimdDbl simdFillDbl(double x) {
+  return _mm512_set1_pd(x);
+}
+
+static inline SimdMask simdGt(SimdInt x, SimdInt y) {
+  return _mm512_cmpgt_epi32_mask(x, y);
+}
+
+static inline SimdInt simdGe1(SimdInt x, SimdInt y) {
+  return _mm512_movm_epi8(_mm512_cmpge_epu8_mask(x, y));
+}
+
+static inline SimdInt simdAdd(SimdInt x, SimdInt y) {
+  return _mm512_add_epi32(x, y);
+}
+
+static inline SimdInt simdAdd1(SimdInt x, SimdInt y) {
+  return _mm512_add_epi8(x, y);
+}
+
+static inline SimdInt simdAdds1(SimdInt x, SimdInt y) {
+  return _mm512_adds_epu8(x, y);
+}
+
+static inline SimdDbl simdAddDbl(SimdDbl x, SimdDbl y) {
+  return _mm512_add_pd(x, y);
+}
+
+static inline SimdInt simdSub(SimdInt x, SimdInt y) {
+  return _mm512_sub_epi32(x, y);
+}
+
+static inline SimdInt simdSub1(SimdInt x, SimdInt y) {
+  return _mm512_sub_epi8(x, y);
+}
+
+static inline SimdDbl simdMulDbl(SimdDbl x, SimdDbl y) {
+  return _mm512_mul_pd(x, y);
+}
+
+static inline SimdInt simdQuadruple1(SimdInt x) {
+  return _mm512_slli_epi32(x, 2);
+}
+
+static inline SimdInt simdMax(SimdInt x, SimdInt y) {
+  return _mm512_max_epi32(x, y);
+}
+
+static inline SimdInt simdMin1(SimdInt x, SimdInt y) {
+  return _mm512_min_epu8(x, y);
+}
+
+static inline int simdHorizontalMax(SimdInt x) {
+  return _mm512_reduce_max_epi32(x);
+}
+
+static inline int simdHorizontalMin1(SimdInt x) {
+  __m256i y = _mm512_castsi512_si256(x);
+  y = _mm256_min_epu8(y, _mm512_extracti64x4_epi64(x, 1));
+  __m128i z = _mm256_castsi256_si128(y);
+  z = _mm_min_epu8(z, _mm256_extracti128_si256(y, 1));
+  z = _mm_min_epu8(z, _mm_srli_epi16(z, 8));
+  z = _mm_minpos_epu16(z);
+  return _mm_extract_epi16(z, 0);
+}
+
+static inline double simdHorizontalAddDbl(SimdDbl x) {
+  return _mm512_reduce_add_pd(x);
+}
+
+static inline SimdInt simdChoose1(SimdInt items, SimdInt choices) {
+  return _mm512_shuffle_epi8(items, choices);
+}
+
+#elif defined __AVX2__
 
 typedef __m256i SimdInt;
 typedef __m256i SimdUint1;
@@ -533,6 +719,39 @@ static inline double simdHorizontalAddDbl(double x) { return x; }
 
 #endif
 
+// Some kernels get compiled a second and third time, with AVX2 or
+// AVX-512BW enabled, and MCF_SIMD_TIER defined.  MCF_SIMD_NAME gives
+// these versions of each kernel different names.  If
+// MCF_SIMD_DISPATCH is true, the baseline version of a kernel should
+// call the version for simdTier().
+
+#if defined MCF_SIMD_TIER && defined __AVX512BW__
+#define MCF_SIMD_NAME(f) f##Avx512
+#elif defined MCF_SIMD_TIER
+#define MCF_SIMD_NAME(f) f##Avx2
+#else
+#define MCF_SIMD_NAME(f) f
+#endif
+
+#if defined __x86_64__ && defined __SSE4_1__ && !defined __AVX2__ \
+  && !defined MCF_SIMD_TIER
+#define MCF_SIMD_DISPATCH 1
+#else
+#define MCF_SIMD_DISPATCH 0
+#endif
+
+#if MCF_SIMD_DISPATCH
+// The widest instruction-set tier that kernels should use: 0 =
+// baseline (SSE4.1), 1 = AVX2, 2 = AVX-512BW.  It starts as the
+// widest that the CPU supports, and may be lowered (e.g. to compare
+// tiers), but not raised.
+inline int &simdTier() {
+  static int tier = __builtin_cpu_supports("avx512bw") ? 2
+    :               __builtin_cpu_supports("avx2")     ? 1 : 0;
+  return tier;
+}
+#endif
+
 }
 
 #endif
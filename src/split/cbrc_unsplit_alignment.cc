@@ -193,6 +193,48 @@ void UnsplitAlignment::init(bool isTopSeqQuery) {
   qQual = qual;
 }
 
+void UnsplitAlignment::initDirectly(char *data) {
+  UnsplitAlignmentHead h;
+  memcpy(&h, data, sizeof h);
+  char *s = data + sizeof h;
+  char *names = s;
+  s += strlen(s) + 1;
+  qname = s;
+  s += strlen(s) + 1;
+  char *refAln = s;
+  size_t alnLen = strlen(s);
+  char *qryAln = refAln + alnLen + 1;
+  char *qual = h.isQual ? qryAln + alnLen + 1 : 0;
+  char *probs = h.isProbs ? qryAln + (alnLen + 1) * (1 + h.isQual) : 0;
+
+  if (h.qstrand == '-') {
+    rstart = h.rlength - h.rstart - h.rspan;
+    qstart = h.qlength - h.qstart - h.qspan;
+    reverseComplement(refAln, refAln + alnLen);
+    reverseComplement(qryAln, qryAln + alnLen);
+    if (qual) std::reverse(qual, qual + alnLen);
+    if (probs) std::reverse(probs, probs + alnLen);
+  } else {
+    rstart = h.rstart;
+    qstart = h.qstart;
+  }
+
+  qstrand = (h.qstrand != h.rstrand) * 2 + (h.qstrand == '-');
+
+  rname = names;
+  rend = rstart + h.rspan;
+  qend = qstart + h.qspan;
+  ralign = refAln;
+  qalign = qryAln;
+  qQual = qual;
+  pAlign = probs;
+  rlength = h.rlength;
+  qlength = h.qlength;
+  strands[0] = h.rstrand;
+  strands[1] = h.qstrand;
+  isAlignProbs = h.isProbs && !h.isCounts;
+}
+
 static size_t seqPosFromAlnPos(size_t alnPos, const char *aln) {
   return alnPos - std::count(aln, aln + alnPos, '-');
 }
@@ -285,8 +327,106 @@ static char asciiFromProb(double probRight) {
   return std::min(s + 33, 126);
 }
 
+static char *putLeft(char *out, const char *s, size_t size, size_t width) {
+  memcpy(out, s, size);
+  memset(out + size, ' ', width - size + 1);
+  return out + width + 1;
+}
+
+static char *putRight(char *out, const IntText &it, int width) {
+  memset(out, ' ', width - it.length);
+  out += width;
+  memcpy(out - it.length, it.text + sizeof it.text - it.length, it.length);
+  *out++ = ' ';
+  return out;
+}
+
+static void writeProbs(char *&out, const double *probs, size_t alnLen,
+		       size_t blankLen, bool isFlipped) {
+  out = putLeft(out, "p", 1, blankLen);
+  std::transform(probs, probs + alnLen, out, asciiFromProb);
+  if (isFlipped) std::reverse(out, out + alnLen);
+  out += alnLen;
+  *out++ = '\n';
+}
+
+// Like mafSlice, for an alignment that was made without MAF text
+static size_t directSlice(std::vector<char> &outputText,
+			  const UnsplitAlignment &aln,
+			  size_t alnBeg, size_t alnEnd, const double *probs) {
+  const char *names[] = {aln.rname, aln.qname};
+  const char *alns[] = {aln.ralign, aln.qalign};
+  size_t starts[] = {aln.rstart, aln.qstart};
+  size_t lengths[] = {aln.rlength, aln.qlength};
+  size_t nameSizes[2];
+  IntText begTexts[2];
+  IntText lenTexts[2];
+  IntText seqLenTexts[2];
+  bool isFlipped = aln.isFlipped();
+  size_t nw = 0, bw = 0, rw = 0, sw = 0;
+
+  for (int j = 0; j < 2; ++j) {
+    size_t begPos = seqPosFromAlnPos(alnBeg, alns[j]);
+    size_t endPos = seqPosFromAlnPos(alnEnd, alns[j]);
+    size_t newBeg = isFlipped ? lengths[j] - starts[j] - endPos
+      :                         starts[j] + begPos;
+    nameSizes[j] = strlen(names[j]);
+    writeSize(begTexts[j], newBeg);
+    writeSize(lenTexts[j], endPos - begPos);
+    writeSize(seqLenTexts[j], lengths[j]);
+    nw = std::max(nw, nameSizes[j]);
+    bw = std::max(bw, size_t(begTexts[j].length));
+    rw = std::max(rw, size_t(lenTexts[j].length));
+    sw = std::max(sw, size_t(seqLenTexts[j].length));
+  }
+
+  size_t alnLen = alnEnd - alnBeg;
+  size_t blankLen = 1 + nw + bw + rw + 1 + sw + 5;  // before the columns
+  size_t lineLength = blankLen + 1 + alnLen + 1;
+  size_t numOfLines = 2 + !!aln.qQual + !!aln.pAlign + !!probs;
+  size_t outputSize = outputText.size();
+  outputText.insert(outputText.end(), numOfLines * lineLength, 0);
+  char *out = &outputText[outputSize];
+
+  for (int j = 0; j < 2; ++j) {
+    out = putLeft(out, "s", 1, 1);
+    out = putLeft(out, names[j], nameSizes[j], nw);
+    out = putRight(out, begTexts[j], bw);
+    out = putRight(out, lenTexts[j], rw);
+    out = putLeft(out, aln.strands + j, 1, 1);
+    out = putRight(out, seqLenTexts[j], sw);
+    memcpy(out, alns[j] + alnBeg, alnLen);
+    if (isFlipped) reverseComplement(out, out + alnLen);
+    out += alnLen;
+    *out++ = '\n';
+  }
+
+  if (aln.qQual) {
+    out = putLeft(out, "q", 1, 1);
+    out = putLeft(out, aln.qname, nameSizes[1], blankLen - 2);
+    memcpy(out, aln.qQual + alnBeg, alnLen);
+    if (isFlipped) std::reverse(out, out + alnLen);
+    out += alnLen;
+    *out++ = '\n';
+  }
+
+  if (aln.pAlign) {
+    out = putLeft(out, "p", 1, blankLen);
+    memcpy(out, aln.pAlign + alnBeg, alnLen);
+    if (isFlipped) std::reverse(out, out + alnLen);
+    out += alnLen;
+    *out++ = '\n';
+  }
+
+  if (probs) writeProbs(out, probs, alnLen, blankLen, isFlipped);
+
+  return lineLength;
+}
+
 size_t mafSlice(std::vector<char> &outputText, const UnsplitAlignment &aln,
 		size_t alnBeg, size_t alnEnd, const double *probs) {
+  if (!aln.linesBeg) return directSlice(outputText, aln, alnBeg, alnEnd, probs);
+
   IntText begTexts[2];
   IntText lenTexts[2];
   int w[6] = {0};
@@ -363,12 +503,8 @@ size_t mafSlice(std::vector<char> &outputText, const UnsplitAlignment &aln,
   }
 
   if (probs) {
-    const char *in = "p";
-    sprintLeft(out, in, w[0] + w[1] + w[2] + w[3] + w[4] + w[5] + 5);
-    std::transform(probs, probs + alnLen, out, asciiFromProb);
-    if (aln.isFlipped()) std::reverse(out, out + alnLen);
-    out += alnLen;
-    *out++ = '\n';
+    size_t blankLen = w[0] + w[1] + w[2] + w[3] + w[4] + w[5] + 5;
+    writeProbs(out, probs, alnLen, blankLen, aln.isFlipped());
   }
 
   return lineLength;
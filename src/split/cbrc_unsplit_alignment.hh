@@ -14,9 +14,29 @@
 
 namespace cbrc {
 
+// The start of an alignment's data, for making an UnsplitAlignment
+// directly, without MAF text.  It's followed by 0-terminated strings:
+// the reference name, the query name, the aligned reference letters,
+// the aligned query letters, and optionally the aligned query
+// qualities and column probability symbols.  Everything is as it
+// would be in MAF.
+struct UnsplitAlignmentHead {
+  size_t rstart;
+  size_t rspan;
+  size_t rlength;
+  size_t qstart;
+  size_t qspan;
+  size_t qlength;
+  char rstrand;
+  char qstrand;
+  bool isQual;
+  bool isProbs;
+  bool isCounts;  // MAF would have a "c" line after the "p" line
+};
+
 class UnsplitAlignment {
 public:
-    char **linesBeg;
+    char **linesBeg;  // null if made directly, without MAF text
     char **linesEnd;
     const char *qname;
     size_t qstart;
@@ -28,10 +48,20 @@ public:
     const char *ralign;
     const char *qalign;
     const char *qQual;
+    // these are only set if made directly:
+    const char *pAlign;  // column probability symbols, or null
+    size_t rlength;
+    size_t qlength;
+    char strands[2];  // the MAF strands of the reference and query
+    bool isAlignProbs;  // would MAF have a "p" line last?
     UnsplitAlignment(){}
     UnsplitAlignment(char **linesBegIn, char **linesEndIn, bool isTopSeqQuery)
       : linesBeg(linesBegIn), linesEnd(linesEndIn) { init(isTopSeqQuery); }
+    // "data" starts with an UnsplitAlignmentHead
+    explicit UnsplitAlignment(char *data)
+      : linesBeg(0), linesEnd(0) { initDirectly(data); }
     void init(bool isTopSeqQuery);
+    void initDirectly(char *data);
     bool isForwardStrand() const { return qstrand < 2; }
     bool isFlipped() const { return qstrand % 2; }
 };
@@ -6,6 +6,7 @@
 #include "last-split.hh"
 
 #include "stringify.hh"
+#include "threadUtil.hh"
 
 #include <getopt.h>
 
@@ -40,11 +41,12 @@ Options:\n\
  -s, --score=INT    " + LastSplitOptions::helps + "\n\
  -n, --no-split     " + LastSplitOptions::helpn + "\n\
  -b, --bytes=B      " + LastSplitOptions::helpb + "\n\
+ -P, --threads=N    " + LastSplitOptions::helpP + "\n\
  -v, --verbose      be verbose\n\
  -V, --version      show version information and exit\n\
 ";
 
-  const char sOpts[] = "hf:rg:d:c:t:M:S:m:s:nb:vV";
+  const char sOpts[] = "hf:rg:d:c:t:M:S:m:s:nb:P:vV";
 
   static struct option lOpts[] = {
     { "help",     no_argument,       0, 'h' },
@@ -60,6 +62,7 @@ Options:\n\
     { "score",    required_argument, 0, 's' },
     { "no-split", no_argument,       0, 'n' },
     { "bytes",    required_argument, 0, 'b' },
+    { "threads",  required_argument, 0, 'P' },
     { "verbose",  no_argument,       0, 'v' },
     { "version",  no_argument,       0, 'V' },
     { 0, 0, 0, 0}
@@ -114,6 +117,9 @@ Options:\n\
     case 'b':
       cbrc::unstringifySize(opts.bytes, optarg);
       break;
+    case 'P':
+      cbrc::unstringify(opts.numOfThreads, optarg);
+      break;
     case 'v':
       opts.verbose = true;
       break;
@@ -129,6 +135,9 @@ Options:\n\
 
   if (opts.inputFileNames.empty()) opts.inputFileNames.push_back("-");
 
+  opts.numOfThreads =
+    cbrc::decideNumberOfThreads(opts.numOfThreads, argv[0], opts.verbose);
+
   std::ios_base::sync_with_stdio(false);  // makes std::cin much faster!!!
 
   lastSplit(opts);
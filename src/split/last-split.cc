@@ -3,6 +3,7 @@
 
 #include "last-split.hh"
 #include "mcf_last_splitter.hh"
+#include "mcf_alignment_records.hh"
 
 #include <string.h>
 
@@ -14,6 +15,13 @@
 #include <stdexcept>
 #include <streambuf>
 
+#ifdef HAS_CXX_THREADS
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
+
 using namespace mcf;
 
 class MyString {
@@ -150,12 +158,225 @@ static void doOneBatch(MyString &inputText,
   }
 }
 
+#ifdef HAS_CXX_THREADS
+// With multiple threads, the main thread reads the input and gathers
+// queries into batches, other threads split the batches, and the
+// main thread writes their output in the input order.
+
+struct SplitBatch {
+  std::vector<char> text;
+  std::vector<size_t> lineEnds;     // offsets in text of line starts/ends
+  std::vector<unsigned> mafEnds;    // which lines are in which MAF block
+  std::vector<size_t> queryEnds;    // which MAF blocks are in which query
+  std::vector<char> output;
+  std::exception_ptr error;
+  bool isSplit;
+  SplitBatch() : lineEnds(1), mafEnds(1), queryEnds(1), isSplit(false) {}
+};
+
+struct SplitPipeline {
+  std::vector<SplitBatch> batches;  // used in turn, round and round
+  size_t numOfFilled;  // batches given to the splitting threads
+  size_t numOfTaken;   // batches taken by the splitting threads
+  size_t numOfWritten;
+  bool isEndOfInput;
+  std::mutex mutex;
+  std::condition_variable isFilled;
+  std::condition_variable isSplit;
+  std::vector<std::thread> threads;
+  const LastSplitOptions *opts;
+  const cbrc::SplitAlignerParams *params;
+  bool isAlreadySplit;
+  ~SplitPipeline();
+};
+
+static const size_t splitBatchBytes = 1 << 20;  // xxx ???
+
+static void splitOneBatch(SplitBatch &b, LastSplitter &splitter,
+			  std::vector<char *> &linePtrs,
+			  const SplitPipeline &p) {
+  linePtrs.resize(b.lineEnds.size());
+  for (size_t i = 0; i < b.lineEnds.size(); ++i) {
+    linePtrs[i] = &b.text[0] + b.lineEnds[i];
+  }
+
+  for (size_t q = 1; q < b.queryEnds.size(); ++q) {
+    size_t beg = b.queryEnds[q-1];
+    size_t end = b.queryEnds[q];
+    splitter.reserve(end - beg);
+    for (size_t i = beg + 1; i <= end; ++i) {
+      splitter.addMaf(&linePtrs[0] + b.mafEnds[i-1],
+		      &linePtrs[0] + b.mafEnds[i], p.opts->isTopSeqQuery);
+    }
+    splitter.split(*p.opts, *p.params, p.isAlreadySplit);
+    splitter.moveOutputTo(b.output);
+  }
+}
+
+static void splitBatches(SplitPipeline *p) {
+  LastSplitter splitter;
+  std::vector<char *> linePtrs;
+  for (;;) {
+    SplitBatch *b;
+    {
+      std::unique_lock<std::mutex> lock(p->mutex);
+      while (p->numOfTaken == p->numOfFilled && !p->isEndOfInput) {
+	p->isFilled.wait(lock);
+      }
+      if (p->numOfTaken == p->numOfFilled) return;
+      b = &p->batches[p->numOfTaken++ % p->batches.size()];
+    }
+    try {
+      splitOneBatch(*b, splitter, linePtrs, *p);
+    } catch (...) {
+      b->error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(p->mutex);
+    b->isSplit = true;
+    p->isSplit.notify_all();
+  }
+}
+
+static void startSplitThreads(SplitPipeline &p, unsigned numOfThreads,
+			      const LastSplitOptions &opts,
+			      const cbrc::SplitAlignerParams &params,
+			      bool isAlreadySplit) {
+  p.batches.resize(numOfThreads * 2);
+  p.numOfFilled = p.numOfTaken = p.numOfWritten = 0;
+  p.isEndOfInput = false;
+  p.opts = &opts;
+  p.params = &params;
+  p.isAlreadySplit = isAlreadySplit;
+  for (unsigned i = 0; i < numOfThreads; ++i) {
+    p.threads.push_back(std::thread(splitBatches, &p));
+  }
+}
+
+static void stopSplitThreads(SplitPipeline &p) {
+  {
+    std::lock_guard<std::mutex> lock(p.mutex);
+    p.isEndOfInput = true;
+  }
+  p.isFilled.notify_all();
+  for (size_t i = 0; i < p.threads.size(); ++i) p.threads[i].join();
+  p.threads.clear();
+}
+
+SplitPipeline::~SplitPipeline() {  // in case we stopped due to an error
+  stopSplitThreads(*this);
+}
+
+static void writeOldestBatch(SplitPipeline &p) {
+  SplitBatch &b = p.batches[p.numOfWritten % p.batches.size()];
+  {
+    std::unique_lock<std::mutex> lock(p.mutex);
+    while (!b.isSplit) p.isSplit.wait(lock);
+  }
+  if (b.error) std::rethrow_exception(b.error);
+  std::cout.write(b.output.data(), b.output.size());
+  b.text.clear();
+  b.lineEnds.resize(1);
+  b.mafEnds.resize(1);
+  b.queryEnds.resize(1);
+  b.output.clear();
+  b.isSplit = false;
+  ++p.numOfWritten;
+}
+
+static void submitBatch(SplitPipeline &p) {
+  SplitBatch &b = p.batches[p.numOfFilled % p.batches.size()];
+  if (b.queryEnds.size() < 2) return;
+  {
+    std::lock_guard<std::mutex> lock(p.mutex);
+    ++p.numOfFilled;
+  }
+  p.isFilled.notify_one();
+  // the next batch to fill may still hold unwritten output:
+  if (p.numOfWritten + p.batches.size() == p.numOfFilled) writeOldestBatch(p);
+}
+
+// Write the output of all queries so far, so that we can then write
+// a comment line in the right place
+static void flushBatches(SplitPipeline &p) {
+  submitBatch(p);
+  while (p.numOfWritten < p.numOfFilled) writeOldestBatch(p);
+}
+
+static void addQueryToBatch(SplitPipeline &p, MyString &inputText,
+			    const std::vector<size_t> &lineEnds,
+			    const std::vector<unsigned> &mafEnds) {
+  SplitBatch &b = p.batches[p.numOfFilled % p.batches.size()];
+  size_t numOfLines = mafEnds.back();
+  size_t numOfChars = lineEnds[numOfLines];
+  size_t oldLineCount = b.lineEnds.size() - 1;
+  size_t oldCharCount = b.text.size();
+  b.text.insert(b.text.end(), &inputText[0], &inputText[0] + numOfChars);
+  for (size_t i = 1; i <= numOfLines; ++i) {
+    b.lineEnds.push_back(oldCharCount + lineEnds[i]);
+  }
+  for (size_t i = 1; i < mafEnds.size(); ++i) {
+    b.mafEnds.push_back(oldLineCount + mafEnds[i]);
+  }
+  b.queryEnds.push_back(b.mafEnds.size() - 1);
+  if (b.text.size() >= splitBatchBytes) submitBatch(p);
+}
+#endif
+
 static void addMaf(std::vector<unsigned> &mafEnds,
 		   const std::vector<size_t> &lineEnds) {
   if (lineEnds.size() - 1 > mafEnds.back())  // if we have new maf lines:
     mafEnds.push_back(lineEnds.size() - 1);
 }
 
+// Split one query's binary alignments, which start at these
+// positions in the input
+static void doOneBinaryQuery(AlignmentRecordReader &reader,
+			     std::vector<size_t> &recordPositions,
+			     LastSplitter &splitter,
+			     const LastSplitOptions &opts,
+			     const cbrc::SplitAlignerParams &params) {
+  splitter.reserve(recordPositions.size());
+  for (size_t i = 0; i < recordPositions.size(); ++i) {
+    char *data = reader.at(recordPositions[i]) + sizeof(AlignmentRecordHead);
+    splitter.addAlignment(data);
+  }
+  recordPositions.clear();
+
+  splitter.split(opts, params, false);
+
+  if (!splitter.isOutputEmpty()) {
+    splitter.printOutput();
+    splitter.clearOutput();
+  }
+}
+
+static void addBinaryAlignment(AlignmentRecordReader &reader,
+			       std::vector<size_t> &recordPositions,
+			       size_t pos, LastSplitter &splitter,
+			       const LastSplitOptions &opts,
+			       const cbrc::SplitAlignerParams &params) {
+  if (opts.isTopSeqQuery)
+    err("can't use option -r with binary alignments");
+  if (opts.no_split)
+    err("can't use option -n with binary alignments");
+
+  AlignmentRecord r;
+  parseAlignmentRecord(r, reader.at(pos));
+  if (r.head.isRefQual)
+    err("can't split binary alignments with reference qualities");
+
+  if (!recordPositions.empty()) {
+    AlignmentRecord old;
+    parseAlignmentRecord(old, reader.at(recordPositions[0]));
+    if (strcmp(old.qname, r.qname)) {
+      doOneBinaryQuery(reader, recordPositions, splitter, opts, params);
+    }
+  }
+
+  if (recordPositions.empty()) reader.discardBefore(pos);
+  recordPositions.push_back(pos);
+}
+
 static void eraseOldInput(MyString &inputText,
 			  std::vector<size_t> &lineEnds,
 			  std::vector<unsigned> &mafEnds) {
@@ -191,12 +412,29 @@ void lastSplit(LastSplitOptions& opts) {
   unsigned sLineCount = 0;
   size_t qNameLineBeg = 0;
   bool isAlreadySplit = false;  // has the input already undergone last-split?
+#ifdef HAS_CXX_THREADS
+  SplitPipeline pipeline;
+  bool isThreaded = false;
+#endif
 
   for (unsigned i = 0; i < opts.inputFileNames.size(); ++i) {
     std::ifstream inFileStream;
     std::istream& input = openIn(opts.inputFileNames[i], inFileStream);
-    while (inputText.appendLine(input)) {
-      const char *linePtr = &inputText[0] + lineEnds.back();
+    AlignmentRecordReader reader;
+    std::vector<size_t> recordPositions;
+    bool isBinary = isBinaryAlignments(input);
+    if (isBinary) reader.open(opts.inputFileNames[i], &input);
+    for (;;) {
+      const char *linePtr;
+      size_t recordPos;
+      bool isRecord = false;
+      if (isBinary) {
+	if (!reader.next(recordPos, isRecord)) break;
+	linePtr = isRecord ? "" : reader.at(recordPos);
+      } else {
+	if (!inputText.appendLine(input)) break;
+	linePtr = &inputText[0] + lineEnds.back();
+      }
       if (state == -1) {  // we are reading the score matrix within the header
 	std::istringstream ls(linePtr);
 	std::vector<int> row;
@@ -239,7 +477,7 @@ void lastSplit(LastSplitOptions& opts) {
 	  }
 	  // try to determine if last-split was already run (fragile):
 	  if (startsWith(linePtr, "# m=")) isAlreadySplit = true;
-	} else if (!isBlankLine(linePtr)) {
+	} else if (isRecord || !isBlankLine(linePtr)) {
 	  if (scoreMatrix.empty())
 	    err("I need a header with score parameters");
 	  if (gapExistenceCost < 0 || gapExtensionCost < 0 ||
@@ -263,17 +501,35 @@ void lastSplit(LastSplitOptions& opts) {
 	  params.print();
 	  std::cout << "#\n";
 	  state = 1;
+#ifdef HAS_CXX_THREADS
+	  if (opts.numOfThreads > 1 && !isBinary) {
+	    startSplitThreads(pipeline, opts.numOfThreads, opts, params,
+			      isAlreadySplit);
+	    isThreaded = true;
+	  }
+#endif
 	}
       }
       if (linePtr[0] == '#' && !startsWith(linePtr, "# batch")) {
+#ifdef HAS_CXX_THREADS
+	if (isThreaded && state == 1) flushBatches(pipeline);
+#endif
 	std::cout << linePtr << "\n";
       }
       if (state == 1) {  // we are reading alignments
-	if (isBlankLine(linePtr)) {
+	if (isBinary) {
+	  if (isRecord) addBinaryAlignment(reader, recordPositions, recordPos,
+					   splitter, opts, params);
+	} else if (isBlankLine(linePtr)) {
 	  addMaf(mafEnds, lineEnds);
 	} else if (strchr(opts.no_split ? "asqpc" : "sqp", linePtr[0])) {
 	  if (!opts.isTopSeqQuery && linePtr[0] == 's' && sLineCount++ % 2 &&
 	      !isSameName(&inputText[qNameLineBeg], linePtr)) {
+#ifdef HAS_CXX_THREADS
+	    if (isThreaded) {
+	      addQueryToBatch(pipeline, inputText, lineEnds, mafEnds);
+	    } else
+#endif
 	    doOneBatch(inputText, lineEnds, mafEnds, splitter, opts, params,
 		       isAlreadySplit);
 	    eraseOldInput(inputText, lineEnds, mafEnds);
@@ -284,8 +540,19 @@ void lastSplit(LastSplitOptions& opts) {
       }
       inputText.resize(lineEnds.back());
     }
+    if (!recordPositions.empty()) {
+      doOneBinaryQuery(reader, recordPositions, splitter, opts, params);
+    }
   }
   addMaf(mafEnds, lineEnds);
+#ifdef HAS_CXX_THREADS
+  if (isThreaded) {
+    addQueryToBatch(pipeline, inputText, lineEnds, mafEnds);
+    flushBatches(pipeline);
+    stopSplitThreads(pipeline);
+    return;
+  }
+#endif
   doOneBatch(inputText, lineEnds, mafEnds, splitter, opts, params,
 	     isAlreadySplit);
 }
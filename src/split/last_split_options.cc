@@ -31,6 +31,7 @@ LastSplitOptions::LastSplitOptions()
     score(-1),
     no_split(false),
     bytes(0),
+    numOfThreads(1),
     verbose(false),
     isSplicedAlignment(false) {}
 
@@ -70,6 +71,9 @@ const char LastSplitOptions::helpn[] =
 const char LastSplitOptions::helpb[] =
   "maximum memory (default: 8T for split, 8G for spliced)";
 
+const char LastSplitOptions::helpP[] =
+  "number of parallel threads (0 = all cores) (default: 1)";
+
 static size_t defaultBytes(bool isSplicedAlignment) {
   size_t b = isSplicedAlignment ? 8 : 8 * 1024;
   for (int i = 0; i < 3; ++i) {
@@ -22,6 +22,7 @@ struct LastSplitOptions {
   int score;
   bool no_split;
   size_t bytes;
+  unsigned numOfThreads;
   bool verbose;
   bool isSplicedAlignment;
   std::vector<std::string> inputFileNames;
@@ -38,6 +39,7 @@ struct LastSplitOptions {
   static const char helps[];
   static const char helpn[];
   static const char helpb[];
+  static const char helpP[];
 
   LastSplitOptions();
 
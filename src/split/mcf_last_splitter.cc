@@ -28,8 +28,7 @@ static bool lessForOneQuery(const cbrc::UnsplitAlignment& a,
   int ralignCmp = strcmp(a.ralign, b.ralign);
   if (ralignCmp != 0        ) return ralignCmp < 0;
   int rnameCmp = strcmp(a.rname, b.rname);
-  if (rnameCmp  != 0        ) return rnameCmp  < 0;
-  return a.linesBeg < b.linesBeg;  // stabilizes the sort
+  return rnameCmp < 0;  // the sort is stable
 }
 
 static bool less(const cbrc::UnsplitAlignment& a,
@@ -123,14 +122,17 @@ void LastSplitter::doOneAlignmentPart(const LastSplitOptions &opts,
   if (mismap > opts.mismap) return;
 
   bool isSplitProbs = (isAlreadySplit && a.linesEnd[-1][0] == 'p');
-  bool isAlignProbs = (a.linesEnd[-1-isAlreadySplit][0] == 'p');
+  bool isAlignProbs = a.linesBeg ? (a.linesEnd[-1-isAlreadySplit][0] == 'p')
+    :                              a.isAlignProbs;
   int format = opts.format ? opts.format : "mM"[isAlignProbs];
   int mismapPrecision = 3 - isSplitProbs;
   if (format == 'm' && !isSplitProbs) probs = 0;
 
-  bool isCopyFirstLine = (opts.no_split && a.linesBeg[0][0] == 'a');
-  size_t firstLineSize = a.linesBeg[1] - a.linesBeg[0] - 1;
-  size_t aLineSpace = firstLineSize * isCopyFirstLine + 128;
+  bool isCopyFirstLine =
+    (opts.no_split && a.linesBeg && a.linesBeg[0][0] == 'a');
+  size_t firstLineSize =
+    isCopyFirstLine ? a.linesBeg[1] - a.linesBeg[0] - 1 : 0;
+  size_t aLineSpace = firstLineSize + 128;
   size_t outputSize = outputText.size();
   outputText.resize(outputSize + aLineSpace);
   size_t lineLen = cbrc::mafSlice(outputText, a, sd.alnBeg, sd.alnEnd, probs);
@@ -181,7 +183,7 @@ void LastSplitter::doOneAlignmentPart(const LastSplitOptions &opts,
   memmove(out, sliceBeg, sliceEnd - sliceBeg);
   outputText.resize(out + (sliceEnd - sliceBeg) - &outputText[0]);
 
-  if (opts.no_split && a.linesEnd[-1][0] == 'c') {
+  if (opts.no_split && a.linesBeg && a.linesEnd[-1][0] == 'c') {
     outputText.insert(outputText.end(), a.linesEnd[-1], a.linesEnd[0]);
     outputText.back() = '\n';
   }
@@ -280,7 +282,7 @@ void LastSplitter::doOneQuery(const LastSplitOptions &opts,
 
 void LastSplitter::splitOneQuery(const LastSplitOptions &opts,
 				 const cbrc::SplitAlignerParams &params) {
-  sort(mafs.begin(), mafs.end(), lessForOneQuery);
+  stable_sort(mafs.begin(), mafs.end(), lessForOneQuery);
   doOneQuery(opts, params, false, mafs.data(), mafs.data() + mafs.size());
   mafs.clear();
 }
@@ -288,7 +290,7 @@ void LastSplitter::splitOneQuery(const LastSplitOptions &opts,
 void LastSplitter::split(const LastSplitOptions &opts,
 			 const cbrc::SplitAlignerParams &params,
 			 bool isAlreadySplit) {
-  sort(mafs.begin(), mafs.end(), less);
+  stable_sort(mafs.begin(), mafs.end(), less);
 
   const cbrc::UnsplitAlignment *beg = mafs.data();
   const cbrc::UnsplitAlignment *end = beg + mafs.size();
@@ -34,6 +34,13 @@ public:
     mafs.push_back(cbrc::UnsplitAlignment(linesBeg, linesEnd, isTopSeqQuery));
   }
 
+  // Add an alignment without MAF text: "data" starts with a
+  // cbrc::UnsplitAlignmentHead.  It's modified, and must persist
+  // until split.
+  void addAlignment(char *data) {
+    mafs.push_back(cbrc::UnsplitAlignment(data));
+  }
+
   // Calculate and store output, and clear MAFs
   void split(const LastSplitOptions &opts,
 	     const cbrc::SplitAlignerParams &params, bool isAlreadySplit);
@@ -48,6 +55,12 @@ public:
 
   void clearOutput() { outputText.clear(); }
 
+  // Append the output to v, and clear it
+  void moveOutputTo(std::vector<char> &v) {
+    v.insert(v.end(), outputText.begin(), outputText.end());
+    outputText.clear();
+  }
+
 private:
   cbrc::SplitAligner sa;
   std::vector<cbrc::UnsplitAlignment> mafs;
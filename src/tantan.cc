@@ -7,6 +7,7 @@
 #include <algorithm>  // fill, max
 #include <cassert>
 #include <cmath>  // pow, abs
+#include <cstring>  // memcpy
 #include <iostream>  // cerr
 #include <numeric>  // accumulate
 #include <vector>
@@ -18,10 +19,11 @@ namespace tantan {
 
 using namespace mcf;
 
-void multiplyAll(std::vector<double> &v, double factor) {
-  for (std::vector<double>::iterator i = v.begin(); i < v.end(); ++i)
-    *i *= factor;
-}
+// This file is compiled again for AVX2 and AVX-512BW, so that the
+// loops over repeat offsets use wider vectors.  The Tantan class is
+// in an unnamed namespace, so each compilation has its own copy.
+
+#if !defined MCF_SIMD_TIER
 
 double firstRepeatOffsetProb(double probMult, int maxRepeatOffset) {
   if (probMult < 1 || probMult > 1) {
@@ -41,6 +43,73 @@ void checkForwardAndBackwardTotals(double fTot, double bTot) {
               << "tantan:          backward algorithm total: " << bTot << "\n";
 }
 
+#else
+
+double firstRepeatOffsetProb(double probMult, int maxRepeatOffset);
+
+void checkForwardAndBackwardTotals(double fTot, double bTot);
+
+#endif
+
+#if MCF_SIMD_DISPATCH
+void getProbabilitiesAvx2(const uchar *seqBeg,
+                          const uchar *seqEnd,
+                          int maxRepeatOffset,
+                          const const_double_ptr *likelihoodRatioMatrix,
+                          double repeatProb,
+                          double repeatEndProb,
+                          double repeatOffsetProbDecay,
+                          double firstGapProb,
+                          double otherGapProb,
+                          float *probabilities);
+
+void getProbabilitiesAvx512(const uchar *seqBeg,
+                            const uchar *seqEnd,
+                            int maxRepeatOffset,
+                            const const_double_ptr *likelihoodRatioMatrix,
+                            double repeatProb,
+                            double repeatEndProb,
+                            double repeatOffsetProbDecay,
+                            double firstGapProb,
+                            double otherGapProb,
+                            float *probabilities);
+#endif
+
+// Get table[s[-1]], table[s[-2]], etc. in successive vector lanes.
+// A gather instruction is faster for AVX-512, but not for AVX2.
+static inline SimdDbl reverseLookup(const double *table, const uchar *s) {
+#if defined __AVX512BW__
+  long long b;
+  std::memcpy(&b, s - 8, 8);
+  __m256i x = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(b));
+  x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(7,6,5,4,3,2,1,0));
+  return _mm512_i32gather_pd(x, table, 8);
+#else
+  return simdSetDbl(
+#if defined __SSE4_1__ || defined __ARM_NEON
+#ifdef __AVX2__
+		    table[s[-4]],
+		    table[s[-3]],
+#endif
+		    table[s[-2]],
+#endif
+		    table[s[-1]]);
+#endif
+}
+
+namespace {
+
+void multiplyAll(std::vector<double> &v, double factor) {
+  double *x = BEG(v);
+  int size = v.size();
+  SimdDbl fV = simdFillDbl(factor);
+  int i = 0;
+  for (; i <= size - simdDblLen; i += simdDblLen)
+    simdStoreDbl(x+i, simdMulDbl(simdLoadDbl(x+i), fV));
+  for (; i < size; ++i)
+    x[i] *= factor;
+}
+
 struct Tantan {
   enum { scaleStepSize = 16 };
 
@@ -324,15 +393,7 @@ struct Tantan {
 
     int i = 0;
     for (; i <= maxOffset - simdDblLen; i += simdDblLen) {
-      SimdDbl rV = simdSetDbl(
-#if defined __SSE4_1__ || defined __ARM_NEON
-#ifdef __AVX2__
-			      lrRow[sp[-i-4]],
-			      lrRow[sp[-i-3]],
-#endif
-			      lrRow[sp[-i-2]],
-#endif
-			      lrRow[sp[-i-1]]);
+      SimdDbl rV = reverseLookup(lrRow, sp - i);
       SimdDbl fV = simdLoadDbl(fp+i);
       sV = simdAddDbl(sV, fV);
       SimdDbl xV = simdMulDbl(bV, simdLoadDbl(b2f+i));
@@ -368,15 +429,7 @@ struct Tantan {
 
     int i = 0;
     for (; i <= maxOffset - simdDblLen; i += simdDblLen) {
-      SimdDbl rV = simdSetDbl(
-#if defined __SSE4_1__ || defined __ARM_NEON
-#ifdef __AVX2__
-			      lrRow[sp[-i-4]],
-			      lrRow[sp[-i-3]],
-#endif
-			      lrRow[sp[-i-2]],
-#endif
-			      lrRow[sp[-i-1]]);
+      SimdDbl rV = reverseLookup(lrRow, sp - i);
       SimdDbl fV = simdMulDbl(simdLoadDbl(fp+i), rV);
       sV = simdAddDbl(sV, simdMulDbl(simdLoadDbl(b2f+i), fV));
       simdStoreDbl(fp+i, simdAddDbl(bV, simdMulDbl(tV, fV)));
@@ -479,6 +532,10 @@ struct Tantan {
   }
 };
 
+}
+
+#if !defined MCF_SIMD_TIER
+
 void maskSequences(uchar *seqBeg,
                    uchar *seqEnd,
                    int maxRepeatOffset,
@@ -501,22 +558,40 @@ void maskSequences(uchar *seqBeg,
   maskProbableLetters(seqBeg, seqEnd, probabilities, minMaskProb, maskTable);
 }
 
-void getProbabilities(const uchar *seqBeg,
-                      const uchar *seqEnd,
-                      int maxRepeatOffset,
-                      const const_double_ptr *likelihoodRatioMatrix,
-                      double repeatProb,
-                      double repeatEndProb,
-                      double repeatOffsetProbDecay,
-                      double firstGapProb,
-                      double otherGapProb,
-                      float *probabilities) {
+#endif
+
+void MCF_SIMD_NAME(getProbabilities)(const uchar *seqBeg,
+                                     const uchar *seqEnd,
+                                     int maxRepeatOffset,
+                                     const const_double_ptr *likelihoodRatioMatrix,
+                                     double repeatProb,
+                                     double repeatEndProb,
+                                     double repeatOffsetProbDecay,
+                                     double firstGapProb,
+                                     double otherGapProb,
+                                     float *probabilities) {
+#if MCF_SIMD_DISPATCH
+  if (simdTier() > 1) {
+    return getProbabilitiesAvx512(seqBeg, seqEnd, maxRepeatOffset,
+                                  likelihoodRatioMatrix, repeatProb,
+                                  repeatEndProb, repeatOffsetProbDecay,
+                                  firstGapProb, otherGapProb, probabilities);
+  }
+  if (simdTier() > 0) {
+    return getProbabilitiesAvx2(seqBeg, seqEnd, maxRepeatOffset,
+                                likelihoodRatioMatrix, repeatProb,
+                                repeatEndProb, repeatOffsetProbDecay,
+                                firstGapProb, otherGapProb, probabilities);
+  }
+#endif
   Tantan tantan(seqBeg, seqEnd, maxRepeatOffset, likelihoodRatioMatrix,
                 repeatProb, repeatEndProb, repeatOffsetProbDecay,
                 firstGapProb, otherGapProb);
   tantan.calcRepeatProbs(probabilities);
 }
 
+#if !defined MCF_SIMD_TIER
+
 void maskProbableLetters(uchar *seqBeg,
                          uchar *seqEnd,
                          const float *probabilities,
@@ -546,4 +621,6 @@ void countTransitions(const uchar *seqBeg,
   tantan.countTransitions(transitionCounts);
 }
 
+#endif
+
 }